@@ -52,6 +52,10 @@ function rive.pointer_exit(url, x, y) end
 ---@return vmath.matrix4 matrix Current projection matrix for the window.
 function rive.get_projection_matrix() end
 
+--- Draws the Rive models of the following render.draw() calls straight into a render target, instead of into the Rive render target that is then blitted to the window. This saves the blit and the window sized texture. On OpenGL, Rive is drawn on top of what the render script drew into the target before. On the other graphics backends the target is cleared.
+---@param render_target? handle A render target created with render.render_target(), or nil to draw to the window again.
+function rive.set_render_target(render_target) end
+
 --- Sets or clears the global file listener callback.
 ---@param callback? fun(self, event, data) Callback invoked for file system events; pass nil to disable.
 ---@param callback_self object The calling script instance.
@@ -104,6 +108,19 @@ function rive.set_view_model_instance(url, name) end
 ---@return ViewModelInstanceHandle view_model_instance_handle Handle for the active view model instance.
 function rive.get_view_model_instance(url) end
 
+--- Instantiates artboards ahead of time, e.g. while loading a level. The instances are advanced once, and kept in the instance pool of the file. They are used by the next Rive models created with the same artboard and state machine, so that spawning them doesn't cause a hitch. The file must stay loaded for the instances to be kept.
+---@param url_or_file url|string A Rive model component, or the path of a loaded Rive file (e.g. "/main/hero.rivc").
+---@param options? table Optional settings
+---@param options_artboards table|string Artboard names. Defaults to the artboard of the component, or the default artboard.
+---@param options_state_machine string State machine name. Defaults to the state machine of the component, or the default state machine.
+---@param options_count number Number of instances per artboard. Defaults to 1.
+function rive.prewarm(url_or_file, options) end
+
+--- Compiles the shaders used by Rive files ahead of time, e.g. during a loading screen, so that the first frames drawing them don't stall. An artboard of each file is drawn once, in a frame that isn't shown. How much is compiled by the warm-up depends on the `rive.shader_compilation` project setting.
+---@param urls_or_files url|string|table A Rive model component, the path of a loaded Rive file (e.g. "/main/hero.rivc"), or a table of them. The artboard of the component is drawn, or the default artboard of the file.
+---@param callback? fun(self) Called when the warm-up frame has been submitted, at the start of the next frame.
+function rive.warm_up(urls_or_files, callback) end
+
 --- @class rive.cmd
 rive.cmd = {}
 
@@ -15,17 +15,28 @@
 #include <stdint.h>
 
 #include <dmsdk/dlib/atomic.h>
+#include <dmsdk/dlib/condition_variable.h>
 #include <dmsdk/dlib/mutex.h>
+#include <dmsdk/dlib/profile.h>
 #include <dmsdk/dlib/thread.h>
 #include <dmsdk/dlib/time.h>
 
 #include <rive/artboard.hpp>
+#include <rive/animation/state_machine_instance.hpp>
 #include <rive/factory.hpp>
 #include <rive/refcnt.hpp>
 
 #include <rive/command_queue.hpp>
 #include <rive/command_server.hpp>
 
+DM_PROPERTY_GROUP(rmtp_RiveFences, "Rive Fences", 0);
+DM_PROPERTY_U32(rmtp_RiveFenceWait, 0, PROFILE_PROPERTY_FRAME_RESET, "Time waiting on fences (us)", &rmtp_RiveFences);
+DM_PROPERTY_U32(rmtp_RiveFenceLt100us, 0, PROFILE_PROPERTY_FRAME_RESET, "# fences < 100us", &rmtp_RiveFences);
+DM_PROPERTY_U32(rmtp_RiveFenceLt500us, 0, PROFILE_PROPERTY_FRAME_RESET, "# fences < 500us", &rmtp_RiveFences);
+DM_PROPERTY_U32(rmtp_RiveFenceLt1ms, 0, PROFILE_PROPERTY_FRAME_RESET, "# fences < 1ms", &rmtp_RiveFences);
+DM_PROPERTY_U32(rmtp_RiveFenceLt4ms, 0, PROFILE_PROPERTY_FRAME_RESET, "# fences < 4ms", &rmtp_RiveFences);
+DM_PROPERTY_U32(rmtp_RiveFenceGe4ms, 0, PROFILE_PROPERTY_FRAME_RESET, "# fences >= 4ms", &rmtp_RiveFences);
+
 namespace dmRiveCommands {
 
 struct Context
@@ -34,6 +45,18 @@ struct Context
     int32_atomic_t      m_Run;
     dmMutex::HMutex     m_Mutex;
 
+    // The command thread parks on this until it is kicked
+    dmMutex::HMutex                         m_WorkMutex;
+    dmConditionVariable::HConditionVariable m_WorkCondition;
+    int32_atomic_t                          m_WorkPending;
+    uint32_t                                m_SpinTime;     // Time (us) to keep polling before parking
+
+    // Fences are signaled by the command server, in the order they were inserted
+    dmMutex::HMutex                         m_FenceMutex;
+    dmConditionVariable::HConditionVariable m_FenceCondition;
+    FenceId                                 m_FenceInserted;    // Only touched by the main thread
+    FenceId                                 m_FenceSignaled;    // Protected by m_FenceMutex
+
     dmRive::HRenderContext          m_RenderContext;
     rive::Factory*                  m_Factory;
     rive::CommandServer*            m_CommandServer;
@@ -42,6 +65,22 @@ struct Context
 
 Context* g_Context = 0;
 
+static void KickInternal(Context* context)
+{
+    if (!context->m_Thread)
+    {
+        return;
+    }
+
+    // Only take the lock on the transition to pending (the store returns the previous value).
+    // The thread resets the flag before it processes the commands.
+    if (dmAtomicStore32(&context->m_WorkPending, 1) == 0)
+    {
+        DM_MUTEX_SCOPED_LOCK(context->m_WorkMutex);
+        dmConditionVariable::Signal(context->m_WorkCondition);
+    }
+}
+
 static void DestroyContext(Context* context)
 {
     if (context == 0)
@@ -56,6 +95,7 @@ static void DestroyContext(Context* context)
         {
             context->m_CommandQueue->disconnect();
         }
+        KickInternal(context);
         dmThread::Join(context->m_Thread);
         context->m_Thread = 0;
     }
@@ -70,6 +110,15 @@ static void DestroyContext(Context* context)
 
     context->m_Mutex = 0;
 
+    if (context->m_WorkCondition)
+        dmConditionVariable::Delete(context->m_WorkCondition);
+    if (context->m_WorkMutex)
+        dmMutex::Delete(context->m_WorkMutex);
+    if (context->m_FenceCondition)
+        dmConditionVariable::Delete(context->m_FenceCondition);
+    if (context->m_FenceMutex)
+        dmMutex::Delete(context->m_FenceMutex);
+
     delete context;
 }
 
@@ -85,38 +134,112 @@ static void PumpMessagesLocked(Context* context)
 
 static void PumpMessages(Context* context)
 {
+    if (context->m_Thread)
+    {
+        // The message side of the queue has its own lock, and the render context
+        // is only touched by the server, so there is no need to stall the command thread.
+        context->m_CommandQueue->processMessages();
+        return;
+    }
+
     DM_MUTEX_OPTIONAL_SCOPED_LOCK(context->m_Mutex);
     PumpMessagesLocked(context);
 }
 
+static void SignalFence(Context* context, FenceId fence)
+{
+    DM_MUTEX_SCOPED_LOCK(context->m_FenceMutex);
+    if (fence > context->m_FenceSignaled)
+    {
+        context->m_FenceSignaled = fence;
+    }
+    dmConditionVariable::Broadcast(context->m_FenceCondition);
+}
+
+static bool IsFenceSignaledInternal(Context* context, FenceId fence)
+{
+    DM_MUTEX_SCOPED_LOCK(context->m_FenceMutex);
+    return context->m_FenceSignaled >= fence;
+}
+
+static FenceId InsertFenceInternal(Context* context)
+{
+    FenceId fence = ++context->m_FenceInserted;
+    context->m_CommandQueue->runOnce([context, fence](rive::CommandServer*) {
+        SignalFence(context, fence);
+    });
+    KickInternal(context);
+    return fence;
+}
+
+static void AddFenceLatency(uint64_t elapsed)
+{
+    DM_PROPERTY_ADD_U32(rmtp_RiveFenceWait, (uint32_t)elapsed);
+    if (elapsed < 100)
+        DM_PROPERTY_ADD_U32(rmtp_RiveFenceLt100us, 1);
+    else if (elapsed < 500)
+        DM_PROPERTY_ADD_U32(rmtp_RiveFenceLt500us, 1);
+    else if (elapsed < 1000)
+        DM_PROPERTY_ADD_U32(rmtp_RiveFenceLt1ms, 1);
+    else if (elapsed < 4000)
+        DM_PROPERTY_ADD_U32(rmtp_RiveFenceLt4ms, 1);
+    else
+        DM_PROPERTY_ADD_U32(rmtp_RiveFenceGe4ms, 1);
+}
+
+static void WaitFenceInternal(Context* context, FenceId fence)
+{
+    uint64_t start = dmTime::GetMonotonicTime();
+
+    if (context->m_Thread)
+    {
+        DM_PROFILE("RiveWaitFence");
+        DM_MUTEX_SCOPED_LOCK(context->m_FenceMutex);
+        while (context->m_FenceSignaled < fence)
+        {
+            dmConditionVariable::Wait(context->m_FenceCondition, context->m_FenceMutex);
+        }
+    }
+    else
+    {
+        // Without a thread, the server executes the fence when we process the commands
+        while (!IsFenceSignaledInternal(context, fence))
+        {
+            DM_MUTEX_OPTIONAL_SCOPED_LOCK(context->m_Mutex);
+            context->m_CommandServer->processCommands();
+        }
+    }
+
+    AddFenceLatency(dmTime::GetMonotonicTime() - start);
+}
+
 template <typename Fn>
 static bool RunOnServerAndWait(Context* context, Fn fn)
 {
     assert(context != 0);
     assert(context->m_CommandQueue);
 
-    int32_atomic_t done = 0;
-    context->m_CommandQueue->runOnce([&done, fn](rive::CommandServer* server) mutable {
+    FenceId fence = ++context->m_FenceInserted;
+    context->m_CommandQueue->runOnce([context, fence, fn](rive::CommandServer* server) mutable {
         fn(server);
-        dmAtomicStore32(&done, 1);
+        SignalFence(context, fence);
     });
+    KickInternal(context);
 
-    while (dmAtomicGet32(&done) == 0)
-    {
-        PumpMessages(context);
-        if (dmAtomicGet32(&done) != 0)
-        {
-            break;
-        }
-
-        dmTime::Sleep(1000);
-    }
+    WaitFenceInternal(context, fence);
 
     // Ensure listener callbacks produced by the fenced work are delivered.
     PumpMessages(context);
     return true;
 }
 
+static bool ServeCommands(Context* ctx)
+{
+    // This lock is due to RenderContext interactions
+    DM_MUTEX_OPTIONAL_SCOPED_LOCK(ctx->m_Mutex);
+    return ctx->m_CommandServer->processCommands();
+}
+
 static void RiveCommandThread(void* _ctx)
 {
     Context* ctx = (Context*)_ctx;
@@ -124,19 +247,27 @@ static void RiveCommandThread(void* _ctx)
 
     while (dmAtomicGet32(&ctx->m_Run))
     {
-        bool keep_running = true;
         {
-            // This lock is due to RenderContext interactions
-            DM_MUTEX_OPTIONAL_SCOPED_LOCK(ctx->m_Mutex);
-            keep_running = ctx->m_CommandServer->processCommands();
+            DM_MUTEX_SCOPED_LOCK(ctx->m_WorkMutex);
+            while (dmAtomicGet32(&ctx->m_WorkPending) == 0 && dmAtomicGet32(&ctx->m_Run))
+            {
+                dmConditionVariable::Wait(ctx->m_WorkCondition, ctx->m_WorkMutex);
+            }
         }
 
-        if (keep_running == false)
+        // Keep serving as long as new work arrives within the spin window
+        uint64_t spin_end = 0;
+        do
         {
-            break;
-        }
-
-        dmTime::Sleep(1);
+            if (dmAtomicStore32(&ctx->m_WorkPending, 0) != 0)
+            {
+                if (!ServeCommands(ctx))
+                {
+                    return;
+                }
+                spin_end = dmTime::GetMonotonicTime() + ctx->m_SpinTime;
+            }
+        } while (ctx->m_SpinTime != 0 && dmAtomicGet32(&ctx->m_Run) && dmTime::GetMonotonicTime() < spin_end);
     }
 }
 
@@ -147,6 +278,11 @@ Result Initialize(InitParams* params)
     g_Context = new Context;
     memset(g_Context, 0, sizeof(*g_Context));
     g_Context->m_Mutex = params->m_Mutex;
+    g_Context->m_SpinTime = params->m_SpinTime;
+    g_Context->m_WorkMutex = dmMutex::New();
+    g_Context->m_WorkCondition = dmConditionVariable::New();
+    g_Context->m_FenceMutex = dmMutex::New();
+    g_Context->m_FenceCondition = dmConditionVariable::New();
 
     g_Context->m_RenderContext = params->m_RenderContext;
     g_Context->m_Factory = params->m_Factory;
@@ -203,7 +339,8 @@ Result ProcessMessages()
     assert(g_Context != 0);
     if (g_Context->m_Thread)
     {
-        RunOnServerAndWait(g_Context, [](rive::CommandServer*) {});
+        WaitFenceInternal(g_Context, InsertFenceInternal(g_Context));
+        PumpMessages(g_Context);
     }
     else
     {
@@ -212,6 +349,78 @@ Result ProcessMessages()
     return RESULT_OK;
 }
 
+FenceId InsertFence()
+{
+    assert(g_Context != 0);
+    return InsertFenceInternal(g_Context);
+}
+
+bool IsFenceSignaled(FenceId fence)
+{
+    assert(g_Context != 0);
+    return IsFenceSignaledInternal(g_Context, fence);
+}
+
+void WaitFence(FenceId fence)
+{
+    assert(g_Context != 0);
+    WaitFenceInternal(g_Context, fence);
+}
+
+Result PollMessages()
+{
+    assert(g_Context != 0);
+    KickInternal(g_Context);
+    PumpMessages(g_Context);
+    return RESULT_OK;
+}
+
+void Kick()
+{
+    assert(g_Context != 0);
+    KickInternal(g_Context);
+}
+
+bool IsThreaded()
+{
+    return g_Context != 0 && g_Context->m_Thread != 0;
+}
+
+FenceId AdvanceStateMachines(AdvanceEntry* entries, uint32_t count, uint32_t budget)
+{
+    assert(g_Context != 0);
+    Context* context = g_Context;
+
+    FenceId fence = ++context->m_FenceInserted;
+    context->m_CommandQueue->runOnce([context, fence, entries, count, budget](rive::CommandServer* server) {
+        uint64_t deadline = dmTime::GetMonotonicTime() + budget;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            AdvanceEntry& entry = entries[i];
+            if (budget != 0 && i != 0 && dmTime::GetMonotonicTime() >= deadline)
+            {
+                for (; i < count; ++i)
+                {
+                    entries[i].m_Result = ADVANCE_RESULT_DEFERRED;
+                }
+                break;
+            }
+
+            rive::StateMachineInstance* instance = server->getStateMachineInstance(entry.m_StateMachine);
+            if (instance == 0)
+            {
+                entry.m_Result = 0;
+                continue;
+            }
+
+            bool keep_going = instance->advanceAndApply(entry.m_DeltaTime);
+            entry.m_Result = ADVANCE_RESULT_ADVANCED | (keep_going ? 0 : ADVANCE_RESULT_SETTLED);
+        }
+        SignalFence(context, fence);
+    });
+    return fence;
+}
+
 bool WaitUntil(bool (*condition)(void*), void* user_data, uint64_t timeout)
 {
     assert(g_Context != 0);
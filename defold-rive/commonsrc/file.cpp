@@ -532,12 +532,20 @@ rive::Mat2D CalcTransformGame(rive::ArtboardInstance* artboard,
         return rive::Mat2D();
     }
 
+    return CalcTransformGame(artboard->bounds(), view_transform, game_transform, display_factor, window_height);
+}
+
+rive::Mat2D CalcTransformGame(const rive::AABB& bounds,
+                              const rive::Mat2D& view_transform,
+                              const rive::Mat2D& game_transform,
+                              float display_factor,
+                              float window_height)
+{
     if (display_factor == 0.0f)
     {
         display_factor = 1.0f;
     }
 
-    rive::AABB bounds = artboard->bounds();
     rive::Mat2D center_adjustment = rive::Mat2D::fromTranslate(-bounds.width() / 2.0f, -bounds.height() / 2.0f);
     rive::Mat2D scale_dpi = rive::Mat2D::fromScale(1, -1);
     rive::Mat2D invert_adjustment = rive::Mat2D::fromScaleAndTranslation(display_factor, -display_factor, 0, window_height);
@@ -17,8 +17,30 @@ namespace dmRive
 		virtual void OnSizeChanged(uint32_t width, uint32_t height, uint32_t sample_count, bool do_final_blit) = 0;
 		virtual void BeginFrame(const rive::gpu::RenderContext::FrameDescriptor& frameDescriptor) = 0;
 		virtual void Flush() = 0;
+		// Submits the frames flushed since the last call, for backends that do their own submission
+		virtual void Submit() = 0;
+		// The GPU time (us) of the flushes that finished since the last call, and how many there were. They finish a frame
+		// or more after they were flushed. Returns false if the GPU time can't be measured, and the time is 0
+		virtual bool TakeGpuTime(uint64_t* time, uint32_t* count) = 0;
 		virtual void SetRenderTargetTexture(dmGraphics::HTexture texture) = 0;
 		virtual void SetGraphicsContext(dmGraphics::HContext graphics_context) = 0;
+		// The number of frames that may be submitted before waiting for the GPU, for backends that do their own submission
+		virtual void SetFramesInFlight(uint32_t count) = 0;
+		// Always use atomic mode instead of raster ordering, for backends where it is chosen when the context is created
+		virtual void SetForceAtomicMode(bool force_atomic) = 0;
+		// Whether atomic mode can be chosen per frame, and is different from raster ordering
+		virtual bool SupportsAtomicModePerFrame() = 0;
+		// The name of the GPU, once the Rive context has been created
+		virtual const char* GetDeviceName() = 0;
+		// How the shader pipelines are compiled when first needed. Only used when the Rive context is created
+		virtual void SetShaderCompilationMode(rive::gpu::ShaderCompilationMode mode) = 0;
+		// Clears a region (in pixels, from the top left) of the Rive render target before a frame that keeps the rest of it.
+		// Returns false if not supported, and the whole target is drawn instead
+		virtual bool ClearRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t clear_color) = 0;
+		// Whether ClearRegion() is implemented at all
+		virtual bool SupportsClearRegion() = 0;
+		// Redirects the next frame into the first color attachment of a Defold render target, until the next Flush
+		virtual bool SetTextureRenderTarget(dmGraphics::HRenderTarget render_target, uint32_t width, uint32_t height) = 0;
 
 		virtual dmGraphics::HTexture GetBackingTexture() = 0;
 		virtual rive::rcp<rive::gpu::Texture> MakeImageTexture(uint32_t width, uint32_t height, uint32_t mipLevelCount, const uint8_t imageDataRGBA[]) = 0;
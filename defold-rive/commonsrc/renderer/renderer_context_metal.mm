@@ -12,28 +12,46 @@
 #import <Metal/Metal.h>
 #import <QuartzCore/CAMetalLayer.h>
 
+#include <atomic>
+#include <memory>
+
 namespace dmRive
 {
+    // The Rive render targets made for the textures of rive.set_render_target() and the model render targets
+    static const uint32_t TEXTURE_TARGET_CACHE_SIZE = 4;
+    // A cached render target holds on to its texture, so it is dropped when it hasn't been drawn into for this many flushes
+    static const uint32_t TEXTURE_TARGET_MAX_UNUSED_FLUSHES = 60;
+
+    // Written by the completion handlers of the command buffers, which may run after the renderer is deleted
+    struct MetalGpuTime
+    {
+        std::atomic<uint64_t> m_Time; // us
+        std::atomic<uint32_t> m_Count;
+    };
+
     class DefoldRiveRendererMetal : public IDefoldRiveRenderer
     {
     public:
         DefoldRiveRendererMetal()
         {
-            rive::gpu::RenderContextMetalImpl::ContextOptions metalOptions;
-            metalOptions.shaderCompilationMode = rive::gpu::ShaderCompilationMode::alwaysSynchronous;
-            metalOptions.disableFramebufferReads = true;
-
-            m_RenderContext = rive::gpu::RenderContextMetalImpl::MakeContext(m_GPU, metalOptions);
+            m_ShaderCompilationMode = rive::gpu::ShaderCompilationMode::alwaysSynchronous;
             m_TargetTexture = 0;
+            m_ActiveTextureTarget = 0;
+            m_FlushCount = 0;
+            m_GpuTime = std::make_shared<MetalGpuTime>();
+            m_GpuTime->m_Time = 0;
+            m_GpuTime->m_Count = 0;
         }
 
         rive::Factory* Factory() override
         {
+            EnsureRenderContext();
             return m_RenderContext.get();
         }
 
         rive::Renderer* MakeRenderer() override
         {
+            EnsureRenderContext();
             return new rive::RiveRenderer(m_RenderContext.get());
         }
 
@@ -46,12 +64,35 @@ namespace dmRive
         {
             @autoreleasepool {
                 id<MTLCommandBuffer> flushCommandBuffer = [m_Queue commandBuffer];
+                rive::gpu::RenderTargetMetal* render_target = m_ActiveTextureTarget ? m_ActiveTextureTarget : m_RenderTarget.get();
                 m_RenderContext->flush({
-                    .renderTarget = m_RenderTarget.get(),
+                    .renderTarget = render_target,
                     .externalCommandBuffer = (__bridge void*) flushCommandBuffer
                 });
 
+                std::shared_ptr<MetalGpuTime> gpu_time = m_GpuTime;
+                [flushCommandBuffer addCompletedHandler:^(id<MTLCommandBuffer> command_buffer) {
+                    // In seconds
+                    CFTimeInterval elapsed = command_buffer.GPUEndTime - command_buffer.GPUStartTime;
+                    if (elapsed > 0.0)
+                    {
+                        gpu_time->m_Time += (uint64_t)(elapsed * 1000000.0);
+                        gpu_time->m_Count += 1;
+                    }
+                }];
                 [flushCommandBuffer commit];
+                m_ActiveTextureTarget = 0;
+
+                ++m_FlushCount;
+                for (uint32_t i = 0; i < TEXTURE_TARGET_CACHE_SIZE; ++i)
+                {
+                    TextureTarget& target = m_TextureTargets[i];
+                    if (target.m_RenderTarget && m_FlushCount - target.m_LastUsed > TEXTURE_TARGET_MAX_UNUSED_FLUSHES)
+                    {
+                        target.m_RenderTarget = nullptr;
+                        target.m_Texture = 0;
+                    }
+                }
             }
         }
 
@@ -104,6 +145,83 @@ namespace dmRive
             }
         }
 
+        void Submit() override
+        {
+            // Each frame is submitted when it is flushed
+        }
+
+        bool TakeGpuTime(uint64_t* time, uint32_t* count) override
+        {
+            *time = m_GpuTime->m_Time.exchange(0);
+            *count = m_GpuTime->m_Count.exchange(0);
+            return true;
+        }
+
+        void SetFramesInFlight(uint32_t count) override
+        {
+            // The Metal submission is done by Rive and Defold
+        }
+
+        void SetForceAtomicMode(bool force_atomic) override
+        {
+            // The Metal context is created with framebuffer reads disabled, which already rules out raster ordering
+        }
+
+        bool SupportsAtomicModePerFrame() override
+        {
+            // Atomic mode is what raster ordering falls back on, see SetForceAtomicMode
+            return false;
+        }
+
+        const char* GetDeviceName() override
+        {
+            return m_GPU ? [m_GPU.name UTF8String] : "";
+        }
+
+        void SetShaderCompilationMode(rive::gpu::ShaderCompilationMode mode) override
+        {
+            if (m_RenderContext)
+            {
+                dmLogWarning("The Rive shader compilation mode can't change after the Metal context has been created");
+            }
+            m_ShaderCompilationMode = mode;
+        }
+
+        bool ClearRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t clear_color) override
+        {
+            // Not implemented for Metal
+            return false;
+        }
+
+        bool SupportsClearRegion() override
+        {
+            return false;
+        }
+
+        bool SetTextureRenderTarget(dmGraphics::HRenderTarget render_target, uint32_t width, uint32_t height) override
+        {
+            @autoreleasepool {
+                dmGraphics::HTexture texture = dmGraphics::GetRenderTargetTexture(m_GraphicsContext, render_target, dmGraphics::BUFFER_TYPE_COLOR0_BIT);
+                void* opaque_texture = texture ? dmGraphics::VulkanTextureToMetal(m_GraphicsContext, texture) : 0;
+                if (!opaque_texture)
+                {
+                    return false;
+                }
+
+                id<MTLTexture> mtl_texture = (__bridge id<MTLTexture>) opaque_texture;
+                TextureTarget* target = GetTextureTarget(texture);
+                if (!target->m_RenderTarget || !target->m_RenderTarget->compatibleWith(mtl_texture))
+                {
+                    auto renderContextImpl = m_RenderContext->static_impl_cast<rive::gpu::RenderContextMetalImpl>();
+                    target->m_RenderTarget = renderContextImpl->makeRenderTarget(mtl_texture.pixelFormat, width, height);
+                }
+                target->m_RenderTarget->setTargetTexture(mtl_texture);
+                target->m_LastUsed     = m_FlushCount;
+                m_ActiveTextureTarget  = target->m_RenderTarget.get();
+                return true;
+            }
+        }
+
         dmGraphics::HTexture GetBackingTexture() override
         {
             return m_BackingTexture;
@@ -138,13 +256,61 @@ namespace dmRive
         }
 
     private:
+        struct TextureTarget
+        {
+            dmGraphics::HTexture                    m_Texture;
+            rive::rcp<rive::gpu::RenderTargetMetal> m_RenderTarget;
+            uint32_t                                m_LastUsed;     // The flush count when it was last drawn into
+        };
+
+        // The cached render target of the texture, or the least recently used one to replace
+        TextureTarget* GetTextureTarget(dmGraphics::HTexture texture)
+        {
+            TextureTarget* oldest = &m_TextureTargets[0];
+            for (uint32_t i = 0; i < TEXTURE_TARGET_CACHE_SIZE; ++i)
+            {
+                TextureTarget& target = m_TextureTargets[i];
+                if (target.m_RenderTarget && target.m_Texture == texture)
+                {
+                    return &target;
+                }
+                if (!target.m_RenderTarget || (oldest->m_RenderTarget && target.m_LastUsed < oldest->m_LastUsed))
+                {
+                    oldest = &target;
+                }
+            }
+            oldest->m_Texture = texture;
+            oldest->m_RenderTarget = nullptr;
+            return oldest;
+        }
+
+        // Created on first use, so that the options can be set before
+        void EnsureRenderContext()
+        {
+            if (m_RenderContext)
+            {
+                return;
+            }
+
+            rive::gpu::RenderContextMetalImpl::ContextOptions metalOptions;
+            metalOptions.shaderCompilationMode = m_ShaderCompilationMode;
+            metalOptions.disableFramebufferReads = true;
+
+            m_RenderContext = rive::gpu::RenderContextMetalImpl::MakeContext(m_GPU, metalOptions);
+        }
+
         id<MTLDevice>                             m_GPU   = MTLCreateSystemDefaultDevice();
         id<MTLCommandQueue>                       m_Queue;
         std::unique_ptr<rive::gpu::RenderContext> m_RenderContext;
         rive::rcp<rive::gpu::RenderTargetMetal>   m_RenderTarget;
+        TextureTarget                             m_TextureTargets[TEXTURE_TARGET_CACHE_SIZE];
+        rive::gpu::RenderTargetMetal*             m_ActiveTextureTarget; // Only set for a single frame
+        uint32_t                                  m_FlushCount;
+        std::shared_ptr<MetalGpuTime>             m_GpuTime;
         dmGraphics::HContext                      m_GraphicsContext;
         dmGraphics::HTexture                      m_BackingTexture;
         dmGraphics::HTexture                      m_TargetTexture;
+        rive::gpu::ShaderCompilationMode          m_ShaderCompilationMode;
     };
 
     IDefoldRiveRenderer* MakeDefoldRiveRendererMetal()
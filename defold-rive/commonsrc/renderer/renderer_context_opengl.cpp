@@ -9,9 +9,12 @@
     #include <GLES3/gl3.h>
 #endif
 
+#include <string.h> // strcmp
+
 #include <dmsdk/graphics/graphics_native.h>
 #include <dmsdk/graphics/graphics_opengl.h>
 #include <dmsdk/dlib/log.h>
+#include <dmsdk/dlib/dstrings.h>
 
 #include "renderer_context.h"
 
@@ -66,6 +69,14 @@ static GLADapiproc Win32GetGLProcAddress(const char* name)
 }
 #endif
 
+// From GL_EXT_disjoint_timer_query, with the same values as GL_ARB_timer_query
+#ifndef GL_TIME_ELAPSED_EXT
+    #define GL_TIME_ELAPSED_EXT 0x88BF
+#endif
+#ifndef GL_GPU_DISJOINT_EXT
+    #define GL_GPU_DISJOINT_EXT 0x8FBB
+#endif
+
 static void OpenGLCheckError(const char* context)
 {
     GLint err = glGetError();
@@ -80,49 +91,34 @@ static void OpenGLCheckError(const char* context)
 
 namespace dmRive
 {
+    // The number of flushes that can be timed while waiting for the results of the earlier ones
+    static const uint32_t GPU_TIMER_QUERY_COUNT = 8;
+
     class DefoldRiveRendererOpenGL : public IDefoldRiveRenderer
     {
     public:
         DefoldRiveRendererOpenGL()
         {
             m_DefoldRenderTarget = 0;
-
-        #ifdef RIVE_DESKTOP_GL
-            // Load the OpenGL API using glad.
-            bool loaded = false;
-            #if defined(DM_PLATFORM_WINDOWS)
-                loaded = gladLoadCustomLoader((GLADloadfunc)Win32GetGLProcAddress) != 0;
-            #else
-                loaded = gladLoadCustomLoader((GLADloadfunc)glfwGetProcAddress) != 0;
-            #endif
-            if (!loaded)
-            {
-                dmLogError("Failed to initialize glad");
-                return;
-            }
-        #endif
-
-            const GLubyte* renderer = glGetString(GL_RENDERER);
-            dmLogInfo("==== GL GPU: %s ====\n", renderer ? (const char*)renderer : "<unknown>");
-
-            m_RenderContext = rive::gpu::RenderContextGLImpl::MakeContext({
-                .disableFragmentShaderInterlock = false // options.disableRasterOrdering,
-            });
-
-            int glerr = (int)glGetError();
-            if (glerr != 0)
-            {
-                dmLogError("Rive OpenGL context produced a gl error: %d", glerr);
-            }
+            m_ShaderCompilationMode = rive::gpu::ShaderCompilationMode::standard;
+            m_DeviceName[0] = 0;
+            m_TimerQueryFirst = 0;
+            m_TimerQueryCount = 0;
+            m_GpuTime = 0;
+            m_GpuTimeCount = 0;
+            m_GpuTimer = false;
+            m_GpuTimerDisjoint = false;
         }
 
         rive::Factory* Factory() override
         {
+            EnsureRenderContext();
             return m_RenderContext.get();
         }
 
         rive::Renderer* MakeRenderer() override
         {
+            EnsureRenderContext();
             return new rive::RiveRenderer(m_RenderContext.get());
         }
 
@@ -136,7 +132,14 @@ namespace dmRive
 
         void Flush() override
         {
-            m_RenderContext->flush({.renderTarget = m_RenderTarget.get()});
+            rive::gpu::RenderTargetGL* render_target = m_TextureRenderTarget ? m_TextureRenderTarget.get() : m_RenderTarget.get();
+            bool timed = BeginGpuTimer();
+            m_RenderContext->flush({.renderTarget = render_target});
+            if (timed)
+            {
+                glEndQuery(GL_TIME_ELAPSED_EXT);
+            }
+            m_TextureRenderTarget = nullptr;
             m_RenderContext->static_impl_cast<rive::gpu::RenderContextGLImpl>()->unbindGLInternalResources();
             OpenGLCheckError("Flush After");
 
@@ -193,6 +196,100 @@ namespace dmRive
 
         }
 
+        void Submit() override
+        {
+            // Each frame is submitted when it is flushed
+        }
+
+        void SetFramesInFlight(uint32_t count) override
+        {
+            // The OpenGL submission is done by Rive and Defold
+        }
+
+        void SetForceAtomicMode(bool force_atomic) override
+        {
+            // Chosen per frame, with FrameDescriptor::disableRasterOrdering. The fragment shader interlock is only used for raster ordering
+        }
+
+        bool SupportsAtomicModePerFrame() override
+        {
+            return true;
+        }
+
+        const char* GetDeviceName() override
+        {
+            return m_DeviceName;
+        }
+
+        void SetShaderCompilationMode(rive::gpu::ShaderCompilationMode mode) override
+        {
+            if (m_RenderContext)
+            {
+                dmLogWarning("The Rive shader compilation mode can't change after the OpenGL context has been created");
+            }
+            m_ShaderCompilationMode = mode;
+        }
+
+        bool ClearRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t clear_color) override
+        {
+            // Only the intermediate framebuffer keeps its contents between frames
+            if (!m_DefoldRenderTarget || !m_RenderTarget)
+            {
+                return false;
+            }
+
+            GLint framebuffer = 0;
+            GLint scissor_box[4];
+            GLboolean scissor_enabled = glIsEnabled(GL_SCISSOR_TEST);
+            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &framebuffer);
+            glGetIntegerv(GL_SCISSOR_BOX, scissor_box);
+
+            // The framebuffer has its origin in the bottom left corner
+            glBindFramebuffer(GL_FRAMEBUFFER, dmGraphics::OpenGLGetRenderTargetId(m_GraphicsContext, m_DefoldRenderTarget));
+            glEnable(GL_SCISSOR_TEST);
+            glScissor(x, m_RenderTarget->height() - (y + height), width, height);
+            glClearColor(((clear_color >> 16) & 0xff) / 255.0f,
+                         ((clear_color >> 8) & 0xff) / 255.0f,
+                         (clear_color & 0xff) / 255.0f,
+                         ((clear_color >> 24) & 0xff) / 255.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+
+            glScissor(scissor_box[0], scissor_box[1], scissor_box[2], scissor_box[3]);
+            if (!scissor_enabled)
+            {
+                glDisable(GL_SCISSOR_TEST);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            OpenGLCheckError("ClearRegion After");
+            return true;
+        }
+
+        bool SupportsClearRegion() override
+        {
+            return true;
+        }
+
+        bool TakeGpuTime(uint64_t* time, uint32_t* count) override
+        {
+            ReadGpuTimers();
+            *time = m_GpuTime;
+            *count = m_GpuTimeCount;
+            m_GpuTime = 0;
+            m_GpuTimeCount = 0;
+            return m_GpuTimer;
+        }
+
+        bool SetTextureRenderTarget(dmGraphics::HRenderTarget render_target, uint32_t width, uint32_t height) override
+        {
+            uint32_t fbo_id = dmGraphics::OpenGLGetRenderTargetId(m_GraphicsContext, render_target);
+            if (fbo_id == 0)
+            {
+                return false;
+            }
+            m_TextureRenderTarget = rive::make_rcp<rive::gpu::FramebufferRenderTargetGL>(width, height, fbo_id, 0);
+            return true;
+        }
+
         dmGraphics::HTexture GetBackingTexture() override
         {
             return dmGraphics::GetRenderTargetTexture(m_GraphicsContext, m_DefoldRenderTarget, dmGraphics::BUFFER_TYPE_COLOR0_BIT);
@@ -225,6 +322,130 @@ namespace dmRive
         }
 
     private:
+        // Created on first use, so that the options can be set before
+        void EnsureRenderContext()
+        {
+            if (m_RenderContext)
+            {
+                return;
+            }
+
+        #ifdef RIVE_DESKTOP_GL
+            // Load the OpenGL API using glad.
+            bool loaded = false;
+            #if defined(DM_PLATFORM_WINDOWS)
+                loaded = gladLoadCustomLoader((GLADloadfunc)Win32GetGLProcAddress) != 0;
+            #else
+                loaded = gladLoadCustomLoader((GLADloadfunc)glfwGetProcAddress) != 0;
+            #endif
+            if (!loaded)
+            {
+                dmLogError("Failed to initialize glad");
+                return;
+            }
+        #endif
+
+            const GLubyte* renderer = glGetString(GL_RENDERER);
+            dmLogInfo("==== GL GPU: %s ====\n", renderer ? (const char*)renderer : "<unknown>");
+            dmStrlCpy(m_DeviceName, renderer ? (const char*)renderer : "", sizeof(m_DeviceName));
+
+            m_RenderContext = rive::gpu::RenderContextGLImpl::MakeContext({
+                .shaderCompilationMode = m_ShaderCompilationMode,
+                .disableFragmentShaderInterlock = false, // Atomic mode is chosen per frame, see SetForceAtomicMode
+            });
+
+            InitGpuTimer();
+
+            int glerr = (int)glGetError();
+            if (glerr != 0)
+            {
+                dmLogError("Rive OpenGL context produced a gl error: %d", glerr);
+            }
+        }
+
+        // The flushes are timed with timer queries, where they are supported. WebGL mostly doesn't expose them.
+        void InitGpuTimer()
+        {
+        #if !defined(RIVE_WEBGL)
+            GLint extension_count = 0;
+            glGetIntegerv(GL_NUM_EXTENSIONS, &extension_count);
+            for (GLint i = 0; i < extension_count; ++i)
+            {
+                const char* extension = (const char*)glGetStringi(GL_EXTENSIONS, i);
+                if (!extension)
+                {
+                    continue;
+                }
+                if (strcmp(extension, "GL_EXT_disjoint_timer_query") == 0)
+                {
+                    m_GpuTimer = true;
+                    m_GpuTimerDisjoint = true;
+                }
+                else if (strcmp(extension, "GL_ARB_timer_query") == 0)
+                {
+                    m_GpuTimer = true;
+                }
+            }
+
+            if (m_GpuTimer)
+            {
+                glGenQueries(GPU_TIMER_QUERY_COUNT, m_TimerQueries);
+            }
+        #endif
+        }
+
+        // Times the next flush, unless all the queries are still waiting for their results
+        bool BeginGpuTimer()
+        {
+            if (!m_GpuTimer)
+            {
+                return false;
+            }
+
+            ReadGpuTimers();
+            if (m_TimerQueryCount == GPU_TIMER_QUERY_COUNT)
+            {
+                return false;
+            }
+
+            glBeginQuery(GL_TIME_ELAPSED_EXT, m_TimerQueries[(m_TimerQueryFirst + m_TimerQueryCount) % GPU_TIMER_QUERY_COUNT]);
+            ++m_TimerQueryCount;
+            return true;
+        }
+
+        // Adds the results that are available to the GPU time, in the order the queries were issued
+        void ReadGpuTimers()
+        {
+            while (m_TimerQueryCount > 0)
+            {
+                GLuint query = m_TimerQueries[m_TimerQueryFirst];
+                GLuint available = 0;
+                glGetQueryObjectuiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available)
+                {
+                    break;
+                }
+
+                GLuint elapsed = 0; // Nanoseconds
+                glGetQueryObjectuiv(query, GL_QUERY_RESULT, &elapsed);
+                m_GpuTime += elapsed / 1000;
+                ++m_GpuTimeCount;
+                m_TimerQueryFirst = (m_TimerQueryFirst + 1) % GPU_TIMER_QUERY_COUNT;
+                --m_TimerQueryCount;
+            }
+
+            // The results are meaningless if the GPU changed its clock, or was reset, while they were measured
+            if (m_GpuTimerDisjoint)
+            {
+                GLint disjoint = 0;
+                glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+                if (disjoint)
+                {
+                    m_GpuTime = 0;
+                    m_GpuTimeCount = 0;
+                }
+            }
+        }
 
         void SetDefoldGraphicsState(dmGraphics::State state, bool flag)
         {
@@ -299,10 +520,20 @@ namespace dmRive
         }
 
         std::unique_ptr<rive::gpu::RenderContext> m_RenderContext;
+        rive::gpu::ShaderCompilationMode          m_ShaderCompilationMode;
+        char                                      m_DeviceName[256];
         dmGraphics::HContext                      m_GraphicsContext;
         rive::rcp<rive::gpu::RenderTargetGL>      m_RenderTarget;
+        rive::rcp<rive::gpu::RenderTargetGL>      m_TextureRenderTarget; // Only set for a single frame
         dmGraphics::PipelineState                 m_DefoldPipelineState;
         dmGraphics::HRenderTarget                 m_DefoldRenderTarget;
+        GLuint                                    m_TimerQueries[GPU_TIMER_QUERY_COUNT];
+        uint32_t                                  m_TimerQueryFirst;  // The oldest query waiting for its result
+        uint32_t                                  m_TimerQueryCount;  // The number of queries waiting for their results
+        uint64_t                                  m_GpuTime;          // The GPU time (us) read since the last TakeGpuTime()
+        uint32_t                                  m_GpuTimeCount;
+        bool                                      m_GpuTimer;         // Timer queries are supported
+        bool                                      m_GpuTimerDisjoint; // GL_GPU_DISJOINT_EXT must be checked
     };
 
     IDefoldRiveRenderer* MakeDefoldRiveRendererOpenGL()
@@ -2,7 +2,11 @@
 
 #include "renderer_context.h"
 
+#include <string.h> // memset
+
 #include <dmsdk/dlib/log.h>
+#include <dmsdk/dlib/dstrings.h>
+#include <dmsdk/dlib/math.h>
 #include <dmsdk/graphics/graphics_vulkan.h>
 #include <dmsdk/graphics/graphics.h>
 
@@ -14,6 +18,11 @@
 
 namespace dmRive
 {
+    // The max number of Rive frames recorded on the CPU while earlier ones are still executing on the GPU
+    static const uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+    // The layout Defold leaves the color textures of its render targets in, to be sampled
+    static const VkImageLayout DEFOLD_TEXTURE_LAYOUT = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
     class DefoldRiveRendererVulkan : public IDefoldRiveRenderer
     {
     public:
@@ -26,13 +35,24 @@ namespace dmRive
             m_Device = VK_NULL_HANDLE;
             m_GraphicsQueue = VK_NULL_HANDLE;
             m_GraphicsQueueFamily = 0;
-            m_CommandPool = VK_NULL_HANDLE;
-            m_FlushCommandBuffer = VK_NULL_HANDLE;
-            m_FlushFence = VK_NULL_HANDLE;
+            memset(m_FlushSlots, 0, sizeof(m_FlushSlots));
+            m_FramesInFlight = 2;
+            m_FlushSlotIndex = 0;
+            m_RecordingSlot = 0;
+            m_TimestampPool = VK_NULL_HANDLE;
+            m_TimestampPeriod = 0.0f;
+            m_TimestampMask = 0;
+            m_GpuTime = 0;
+            m_GpuTimeCount = 0;
             m_FrameNumber = 0;
+            m_CompletedFrameNumber = 0;
             m_Width = 0;
             m_Height = 0;
             m_DoFinalBlit = true;
+            m_TextureTargetActive = false;
+            m_ForceAtomicMode = false;
+            m_ShaderCompilationMode = rive::gpu::ShaderCompilationMode::standard;
+            m_DeviceName[0] = 0;
         }
 
         ~DefoldRiveRendererVulkan() override
@@ -75,66 +95,41 @@ namespace dmRive
 
         void Flush() override
         {
-            if (!m_RenderContext || !m_RenderTarget || !m_GraphicsContext)
-            {
-                return;
-            }
+            rive::gpu::RenderTargetVulkanImpl* render_target = m_TextureTargetActive ? m_TextureRenderTarget.get() : m_RenderTarget.get();
+            m_TextureTargetActive = false;
 
-            if (!EnsureSubmitResources())
+            if (!m_RenderContext || !render_target || !m_GraphicsContext)
             {
                 return;
             }
 
-            VkResult vk_result = vkWaitForFences(m_Device, 1, &m_FlushFence, VK_TRUE, UINT64_MAX);
-            if (vk_result != VK_SUCCESS)
+            // Recorded into the open command buffer, which is submitted by Submit()
+            FlushSlot* recording_slot = BeginRecording();
+            if (!recording_slot)
             {
-                dmLogError("vkWaitForFences failed: %d", (int)vk_result);
-                return;
-            }
-
-            vk_result = vkResetFences(m_Device, 1, &m_FlushFence);
-            if (vk_result != VK_SUCCESS)
-            {
-                dmLogError("vkResetFences failed: %d", (int)vk_result);
-                return;
-            }
-
-            vk_result = vkResetCommandPool(m_Device, m_CommandPool, 0);
-            if (vk_result != VK_SUCCESS)
-            {
-                dmLogError("vkResetCommandPool failed: %d", (int)vk_result);
-                return;
-            }
-
-            VkCommandBufferBeginInfo begin_info = {};
-            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-            vk_result = vkBeginCommandBuffer(m_FlushCommandBuffer, &begin_info);
-            if (vk_result != VK_SUCCESS)
-            {
-                dmLogError("vkBeginCommandBuffer failed: %d", (int)vk_result);
                 return;
             }
+            FlushSlot& slot = *recording_slot;
 
             rive::gpu::RenderContext::FlushResources flush_resources;
-            flush_resources.renderTarget = m_RenderTarget.get();
-            flush_resources.externalCommandBuffer = (void*)m_FlushCommandBuffer;
+            flush_resources.renderTarget = render_target;
+            flush_resources.externalCommandBuffer = (void*)slot.m_CommandBuffer;
             flush_resources.currentFrameNumber = ++m_FrameNumber;
-            // Defold does not expose Vulkan fence-safe frame numbers through the
-            // public SDK, so keep a conservative two-frame delay before Rive
-            // recycles transient GPU resources.
-            flush_resources.safeFrameNumber = (m_FrameNumber > 2) ? (m_FrameNumber - 2) : 0;
+            // Rive recycles the transient GPU resources of the frames our fences have seen complete
+            flush_resources.safeFrameNumber = m_CompletedFrameNumber;
             m_RenderContext->flush(flush_resources);
+            slot.m_FrameNumber = m_FrameNumber;
 
-            if (m_DoFinalBlit)
+            if (m_DoFinalBlit || render_target != m_RenderTarget.get())
             {
+                // Back to the layout Defold expects its textures in
                 const rive::gpu::vkutil::ImageAccess shader_read_access = {
                     .pipelineStages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
                                       VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
                     .accessMask = VK_ACCESS_SHADER_READ_BIT,
-                    .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                    .layout = DEFOLD_TEXTURE_LAYOUT,
                 };
-                m_RenderTarget->accessTargetImageView(m_FlushCommandBuffer, shader_read_access);
+                render_target->accessTargetImageView(slot.m_CommandBuffer, shader_read_access);
             }
             else
             {
@@ -143,25 +138,64 @@ namespace dmRive
                     .accessMask = 0,
                     .layout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
                 };
-                m_RenderTarget->accessTargetImageView(m_FlushCommandBuffer, present_access);
+                m_RenderTarget->accessTargetImageView(slot.m_CommandBuffer, present_access);
+            }
+        }
+
+        void Submit() override
+        {
+            FlushSlot* slot = m_RecordingSlot;
+            if (!slot)
+            {
+                return;
+            }
+            m_RecordingSlot = 0;
+
+            if (m_TimestampPool != VK_NULL_HANDLE)
+            {
+                vkCmdWriteTimestamp(slot->m_CommandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampPool, GetTimestampQuery(*slot) + 1);
             }
 
-            vk_result = vkEndCommandBuffer(m_FlushCommandBuffer);
+            VkResult vk_result = vkEndCommandBuffer(slot->m_CommandBuffer);
             if (vk_result != VK_SUCCESS)
             {
                 dmLogError("vkEndCommandBuffer failed: %d", (int)vk_result);
                 return;
             }
 
+            // The public SDK doesn't expose Defold's frame command buffer, nor the semaphores and fences of its submit,
+            // so Rive is submitted on its own. Both are submitted to the same queue, and this is done while the render
+            // script runs, before Defold submits the frame that samples the result.
             VkSubmitInfo submit_info = {};
             submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
             submit_info.commandBufferCount = 1;
-            submit_info.pCommandBuffers = &m_FlushCommandBuffer;
-            vk_result = vkQueueSubmit(m_GraphicsQueue, 1, &submit_info, m_FlushFence);
+            submit_info.pCommandBuffers = &slot->m_CommandBuffer;
+            vk_result = vkQueueSubmit(m_GraphicsQueue, 1, &submit_info, slot->m_Fence);
             if (vk_result != VK_SUCCESS)
             {
                 dmLogError("vkQueueSubmit failed: %d", (int)vk_result);
+                return;
+            }
+            slot->m_TimestampsPending = m_TimestampPool != VK_NULL_HANDLE;
+        }
+
+        bool TakeGpuTime(uint64_t* time, uint32_t* count) override
+        {
+            // Without waiting for the command buffers still executing
+            for (uint32_t i = 0; i < m_FramesInFlight; ++i)
+            {
+                FlushSlot& slot = m_FlushSlots[i];
+                if (slot.m_TimestampsPending && vkGetFenceStatus(m_Device, slot.m_Fence) == VK_SUCCESS)
+                {
+                    ReadGpuTime(slot);
+                }
             }
+
+            *time = m_GpuTime;
+            *count = m_GpuTimeCount;
+            m_GpuTime = 0;
+            m_GpuTimeCount = 0;
+            return m_TimestampMask != 0;
         }
 
         void OnSizeChanged(uint32_t width, uint32_t height, uint32_t sample_count, bool do_final_blit) override
@@ -209,6 +243,49 @@ namespace dmRive
             }
         }
 
+        void SetFramesInFlight(uint32_t count) override
+        {
+            count = dmMath::Clamp(count, 1u, MAX_FRAMES_IN_FLIGHT);
+            if (count == m_FramesInFlight)
+            {
+                return;
+            }
+
+            // The ring is recreated with the new size on the next flush
+            DestroySubmitResources();
+            m_FramesInFlight = count;
+        }
+
+        void SetForceAtomicMode(bool force_atomic) override
+        {
+            // Only used when the context is created
+            if (m_RenderContext && force_atomic != m_ForceAtomicMode)
+            {
+                dmLogWarning("The Rive render mode can't change the Vulkan context after it has been created");
+            }
+            m_ForceAtomicMode = force_atomic;
+        }
+
+        bool SupportsAtomicModePerFrame() override
+        {
+            // Forced for the whole context when it is created, see SetForceAtomicMode
+            return false;
+        }
+
+        const char* GetDeviceName() override
+        {
+            return m_DeviceName;
+        }
+
+        void SetShaderCompilationMode(rive::gpu::ShaderCompilationMode mode) override
+        {
+            if (m_RenderContext)
+            {
+                dmLogWarning("The Rive shader compilation mode can't change after the Vulkan context has been created");
+            }
+            m_ShaderCompilationMode = mode;
+        }
+
         void SetGraphicsContext(dmGraphics::HContext graphics_context) override
         {
             m_GraphicsContext = graphics_context;
@@ -224,6 +301,61 @@ namespace dmRive
             }
         }
 
+        bool ClearRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t clear_color) override
+        {
+            // vkCmdClearColorImage can't clear a part of an image outside of a render pass
+            return false;
+        }
+
+        bool SupportsClearRegion() override
+        {
+            return false;
+        }
+
+        bool SetTextureRenderTarget(dmGraphics::HRenderTarget render_target, uint32_t width, uint32_t height) override
+        {
+            if (!m_RenderContext)
+            {
+                return false;
+            }
+
+            dmGraphics::HTexture texture = dmGraphics::GetRenderTargetTexture(m_GraphicsContext, render_target, dmGraphics::BUFFER_TYPE_COLOR0_BIT);
+            if (texture == 0)
+            {
+                return false;
+            }
+
+            // The Rive render target owns the intermediate buffers, so it is kept for as long as the size is the same
+            if (!m_TextureRenderTarget || m_TextureRenderTarget->width() != width || m_TextureRenderTarget->height() != height)
+            {
+                auto render_context_impl = m_RenderContext->static_impl_cast<rive::gpu::RenderContextVulkanImpl>();
+                m_TextureRenderTarget = render_context_impl->makeRenderTarget(width,
+                                                                              height,
+                                                                              VK_FORMAT_R8G8B8A8_UNORM,
+                                                                              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                                                              VK_IMAGE_USAGE_SAMPLED_BIT |
+                                                                              VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                                                              VK_IMAGE_USAGE_TRANSFER_DST_BIT);
+                if (!m_TextureRenderTarget)
+                {
+                    return false;
+                }
+            }
+
+            // Defold keeps the color textures of its render targets in the shader read layout outside of its render passes,
+            // and the public SDK has no way to tell it about another one. The texture is taken over in that layout, so that
+            // its contents are kept, and Flush() puts it back in it once Rive has drawn into it.
+            rive::gpu::vkutil::ImageAccess initial_access;
+            initial_access.pipelineStages = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            initial_access.accessMask = VK_ACCESS_SHADER_READ_BIT;
+            initial_access.layout = DEFOLD_TEXTURE_LAYOUT;
+            m_TextureRenderTarget->setTargetImageView(dmGraphics::VulkanGetImageView(m_GraphicsContext, texture),
+                                                      dmGraphics::VulkanGetImage(m_GraphicsContext, texture),
+                                                      initial_access);
+            m_TextureTargetActive = true;
+            return true;
+        }
+
         dmGraphics::HTexture GetBackingTexture() override
         {
             return m_BackingTexture;
@@ -305,6 +437,19 @@ namespace dmRive
             VkPhysicalDeviceProperties properties = {};
             vkGetPhysicalDeviceProperties(physical_device, &properties);
             vulkan_features.apiVersion = properties.apiVersion;
+            dmStrlCpy(m_DeviceName, properties.deviceName, sizeof(m_DeviceName));
+
+            // The GPU time is measured with timestamps, if the graphics queue supports them
+            VkQueueFamilyProperties queue_families[16];
+            uint32_t queue_family_count = sizeof(queue_families) / sizeof(queue_families[0]);
+            vkGetPhysicalDeviceQueueFamilyProperties(physical_device, &queue_family_count, queue_families);
+            uint32_t timestamp_bits = m_GraphicsQueueFamily < queue_family_count ? queue_families[m_GraphicsQueueFamily].timestampValidBits : 0;
+            m_TimestampPeriod = properties.limits.timestampPeriod;
+            m_TimestampMask = timestamp_bits >= 64 ? ~0ULL : (1ULL << timestamp_bits) - 1;
+            if (m_TimestampPeriod <= 0.0f)
+            {
+                m_TimestampMask = 0;
+            }
 
             vulkan_features.rasterizationOrderColorAttachmentAccess =
                 dmGraphics::IsExtensionSupported(m_GraphicsContext, "VK_EXT_rasterization_order_attachment_access");
@@ -314,7 +459,8 @@ namespace dmRive
                 dmGraphics::IsExtensionSupported(m_GraphicsContext, "VK_KHR_portability_subset");
 
             rive::gpu::RenderContextVulkanImpl::ContextOptions options;
-            options.shaderCompilationMode = rive::gpu::ShaderCompilationMode::standard;
+            options.shaderCompilationMode = m_ShaderCompilationMode;
+            options.forceAtomicMode = m_ForceAtomicMode;
 
             m_RenderContext = rive::gpu::RenderContextVulkanImpl::MakeContext(instance,
                                                                               physical_device,
@@ -331,57 +477,188 @@ namespace dmRive
             return true;
         }
 
-        bool EnsureSubmitResources()
+        // Frames complete in submission order, so the most recent one of them is the safe frame number
+        void UpdateCompletedFrameNumber(uint64_t frame_number)
         {
-            if (!EnsureRenderContext())
+            m_CompletedFrameNumber = dmMath::Max(m_CompletedFrameNumber, frame_number);
+            for (uint32_t i = 0; i < m_FramesInFlight; ++i)
             {
-                return false;
+                const FlushSlot& slot = m_FlushSlots[i];
+                if (slot.m_FrameNumber > m_CompletedFrameNumber && vkGetFenceStatus(m_Device, slot.m_Fence) == VK_SUCCESS)
+                {
+                    m_CompletedFrameNumber = slot.m_FrameNumber;
+                }
             }
+        }
 
-            if (m_CommandPool != VK_NULL_HANDLE && m_FlushCommandBuffer != VK_NULL_HANDLE && m_FlushFence != VK_NULL_HANDLE)
+        // Returns the slot whose command buffer the flushes are recorded into until the next Submit(), and begins it
+        // if there is none. Only waits for the command buffer submitted m_FramesInFlight submits ago, so recording
+        // this one overlaps with the GPU executing the ones after it.
+        FlushSlot* BeginRecording()
+        {
+            if (m_RecordingSlot)
             {
-                return true;
+                return m_RecordingSlot;
             }
 
-            VkCommandPoolCreateInfo pool_info = {};
-            pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-            pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-            pool_info.queueFamilyIndex = m_GraphicsQueueFamily;
-            VkResult vk_result = vkCreateCommandPool(m_Device, &pool_info, 0, &m_CommandPool);
+            if (!EnsureSubmitResources())
+            {
+                return 0;
+            }
+
+            FlushSlot& slot = m_FlushSlots[m_FlushSlotIndex];
+            m_FlushSlotIndex = (m_FlushSlotIndex + 1) % m_FramesInFlight;
+
+            VkResult vk_result = vkWaitForFences(m_Device, 1, &slot.m_Fence, VK_TRUE, UINT64_MAX);
             if (vk_result != VK_SUCCESS)
             {
-                dmLogError("vkCreateCommandPool failed: %d", (int)vk_result);
-                DestroySubmitResources();
-                return false;
+                dmLogError("vkWaitForFences failed: %d", (int)vk_result);
+                return 0;
             }
+            UpdateCompletedFrameNumber(slot.m_FrameNumber);
+            ReadGpuTime(slot);
 
-            VkCommandBufferAllocateInfo alloc_info = {};
-            alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-            alloc_info.commandPool = m_CommandPool;
-            alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            alloc_info.commandBufferCount = 1;
-            vk_result = vkAllocateCommandBuffers(m_Device, &alloc_info, &m_FlushCommandBuffer);
+            // All command buffers of the slot are reset at once, instead of one by one
+            vk_result = vkResetCommandPool(m_Device, slot.m_CommandPool, 0);
             if (vk_result != VK_SUCCESS)
             {
-                dmLogError("vkAllocateCommandBuffers failed: %d", (int)vk_result);
-                DestroySubmitResources();
-                return false;
+                dmLogError("vkResetCommandPool failed: %d", (int)vk_result);
+                return 0;
             }
 
-            VkFenceCreateInfo fence_info = {};
-            fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-            fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-            vk_result = vkCreateFence(m_Device, &fence_info, 0, &m_FlushFence);
+            VkCommandBufferBeginInfo begin_info = {};
+            begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+            vk_result = vkBeginCommandBuffer(slot.m_CommandBuffer, &begin_info);
+            if (vk_result != VK_SUCCESS)
+            {
+                dmLogError("vkBeginCommandBuffer failed: %d", (int)vk_result);
+                return 0;
+            }
+
+            if (m_TimestampPool != VK_NULL_HANDLE)
+            {
+                vkCmdResetQueryPool(slot.m_CommandBuffer, m_TimestampPool, GetTimestampQuery(slot), 2);
+                vkCmdWriteTimestamp(slot.m_CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampPool, GetTimestampQuery(slot));
+            }
+
+            // Only reset once it is certain to be submitted again
+            vk_result = vkResetFences(m_Device, 1, &slot.m_Fence);
             if (vk_result != VK_SUCCESS)
             {
-                dmLogError("vkCreateFence failed: %d", (int)vk_result);
-                DestroySubmitResources();
+                dmLogError("vkResetFences failed: %d", (int)vk_result);
+                vkEndCommandBuffer(slot.m_CommandBuffer);
+                return 0;
+            }
+
+            m_RecordingSlot = &slot;
+            return m_RecordingSlot;
+        }
+
+        bool EnsureSubmitResources()
+        {
+            if (!EnsureRenderContext())
+            {
                 return false;
             }
 
+            if (m_FlushSlots[0].m_Fence != VK_NULL_HANDLE)
+            {
+                return true;
+            }
+
+            for (uint32_t i = 0; i < m_FramesInFlight; ++i)
+            {
+                FlushSlot& slot = m_FlushSlots[i];
+
+                VkCommandPoolCreateInfo pool_info = {};
+                pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+                // The pool is reset as a whole, so the command buffers don't need to be resettable one by one
+                pool_info.flags = 0;
+                pool_info.queueFamilyIndex = m_GraphicsQueueFamily;
+                VkResult vk_result = vkCreateCommandPool(m_Device, &pool_info, 0, &slot.m_CommandPool);
+                if (vk_result != VK_SUCCESS)
+                {
+                    dmLogError("vkCreateCommandPool failed: %d", (int)vk_result);
+                    DestroySubmitResources();
+                    return false;
+                }
+
+                VkCommandBufferAllocateInfo alloc_info = {};
+                alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+                alloc_info.commandPool = slot.m_CommandPool;
+                alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+                alloc_info.commandBufferCount = 1;
+                vk_result = vkAllocateCommandBuffers(m_Device, &alloc_info, &slot.m_CommandBuffer);
+                if (vk_result != VK_SUCCESS)
+                {
+                    dmLogError("vkAllocateCommandBuffers failed: %d", (int)vk_result);
+                    DestroySubmitResources();
+                    return false;
+                }
+
+                VkFenceCreateInfo fence_info = {};
+                fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+                fence_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+                vk_result = vkCreateFence(m_Device, &fence_info, 0, &slot.m_Fence);
+                if (vk_result != VK_SUCCESS)
+                {
+                    dmLogError("vkCreateFence failed: %d", (int)vk_result);
+                    DestroySubmitResources();
+                    return false;
+                }
+                slot.m_FrameNumber = 0;
+                slot.m_TimestampsPending = false;
+            }
+
+            if (m_TimestampMask != 0)
+            {
+                VkQueryPoolCreateInfo query_pool_info = {};
+                query_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+                query_pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+                query_pool_info.queryCount = MAX_FRAMES_IN_FLIGHT * 2;
+                VkResult vk_result = vkCreateQueryPool(m_Device, &query_pool_info, 0, &m_TimestampPool);
+                if (vk_result != VK_SUCCESS)
+                {
+                    dmLogWarning("vkCreateQueryPool failed: %d. The Rive GPU time isn't measured", (int)vk_result);
+                    m_TimestampPool = VK_NULL_HANDLE;
+                    m_TimestampMask = 0;
+                }
+            }
+
+            m_FlushSlotIndex = 0;
             return true;
         }
 
+        // The first of the two timestamps written at the start and end of the command buffer of the slot
+        uint32_t GetTimestampQuery(const FlushSlot& slot)
+        {
+            return (uint32_t)(&slot - m_FlushSlots) * 2;
+        }
+
+        // Adds the time between the timestamps of the slot to the GPU time. Its fence must be signaled
+        void ReadGpuTime(FlushSlot& slot)
+        {
+            if (!slot.m_TimestampsPending)
+            {
+                return;
+            }
+            slot.m_TimestampsPending = false;
+
+            uint64_t timestamps[2];
+            VkResult vk_result = vkGetQueryPoolResults(m_Device, m_TimestampPool, GetTimestampQuery(slot), 2, sizeof(timestamps), timestamps,
+                                                       sizeof(timestamps[0]), VK_QUERY_RESULT_64_BIT);
+            if (vk_result != VK_SUCCESS)
+            {
+                return;
+            }
+
+            // The period is in nanoseconds per tick
+            uint64_t ticks = (timestamps[1] - timestamps[0]) & m_TimestampMask;
+            m_GpuTime += (uint64_t)((double)ticks * m_TimestampPeriod / 1000.0);
+            ++m_GpuTimeCount;
+        }
+
         void DestroySubmitResources()
         {
             if (m_Device == VK_NULL_HANDLE)
@@ -389,9 +666,16 @@ namespace dmRive
                 return;
             }
 
-            if (m_FlushFence != VK_NULL_HANDLE)
+            // Its fence is only signaled once it has been submitted
+            Submit();
+
+            for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
             {
-                vkWaitForFences(m_Device, 1, &m_FlushFence, VK_TRUE, UINT64_MAX);
+                if (m_FlushSlots[i].m_Fence != VK_NULL_HANDLE)
+                {
+                    vkWaitForFences(m_Device, 1, &m_FlushSlots[i].m_Fence, VK_TRUE, UINT64_MAX);
+                    UpdateCompletedFrameNumber(m_FlushSlots[i].m_FrameNumber);
+                }
             }
 
             if (m_GraphicsQueue != VK_NULL_HANDLE)
@@ -399,19 +683,31 @@ namespace dmRive
                 vkQueueWaitIdle(m_GraphicsQueue);
             }
 
-            if (m_FlushFence != VK_NULL_HANDLE)
+            for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i)
             {
-                vkDestroyFence(m_Device, m_FlushFence, 0);
-                m_FlushFence = VK_NULL_HANDLE;
+                FlushSlot& slot = m_FlushSlots[i];
+                ReadGpuTime(slot);
+                if (slot.m_Fence != VK_NULL_HANDLE)
+                {
+                    vkDestroyFence(m_Device, slot.m_Fence, 0);
+                    slot.m_Fence = VK_NULL_HANDLE;
+                }
+
+                if (slot.m_CommandPool != VK_NULL_HANDLE)
+                {
+                    vkDestroyCommandPool(m_Device, slot.m_CommandPool, 0);
+                    slot.m_CommandPool = VK_NULL_HANDLE;
+                }
+
+                slot.m_CommandBuffer = VK_NULL_HANDLE;
+                slot.m_FrameNumber = 0;
             }
 
-            if (m_CommandPool != VK_NULL_HANDLE)
+            if (m_TimestampPool != VK_NULL_HANDLE)
             {
-                vkDestroyCommandPool(m_Device, m_CommandPool, 0);
-                m_CommandPool = VK_NULL_HANDLE;
+                vkDestroyQueryPool(m_Device, m_TimestampPool, 0);
+                m_TimestampPool = VK_NULL_HANDLE;
             }
-
-            m_FlushCommandBuffer = VK_NULL_HANDLE;
         }
 
         bool EnsureBackingRenderTarget(uint32_t width, uint32_t height)
@@ -484,8 +780,19 @@ namespace dmRive
             m_RenderTarget->setTargetImageView(image_view, image, initial_access);
         }
 
+        // The command buffer the frames flushed between two submits are recorded into, and the fence signaled when the GPU is done with it
+        struct FlushSlot
+        {
+            VkCommandPool   m_CommandPool;
+            VkCommandBuffer m_CommandBuffer;
+            VkFence         m_Fence;
+            uint64_t        m_FrameNumber; // The last frame recorded into it. 0 if none
+            bool            m_TimestampsPending; // Submitted with timestamps that haven't been read
+        };
+
         std::unique_ptr<rive::gpu::RenderContext>      m_RenderContext;
         rive::rcp<rive::gpu::RenderTargetVulkanImpl>   m_RenderTarget;
+        rive::rcp<rive::gpu::RenderTargetVulkanImpl>   m_TextureRenderTarget;
         dmGraphics::HContext                            m_GraphicsContext;
         dmGraphics::HRenderTarget                       m_BackingRenderTarget;
         dmGraphics::HTexture                            m_BackingTexture;
@@ -493,13 +800,24 @@ namespace dmRive
         VkDevice                                        m_Device;
         VkQueue                                         m_GraphicsQueue;
         uint32_t                                        m_GraphicsQueueFamily;
-        VkCommandPool                                   m_CommandPool;
-        VkCommandBuffer                                 m_FlushCommandBuffer;
-        VkFence                                         m_FlushFence;
+        FlushSlot                                       m_FlushSlots[MAX_FRAMES_IN_FLIGHT];
+        uint32_t                                        m_FramesInFlight;
+        uint32_t                                        m_FlushSlotIndex;
+        FlushSlot*                                      m_RecordingSlot;        // The slot flushed into until the next Submit(). 0 if none
+        VkQueryPool                                     m_TimestampPool;        // Two timestamps per slot, around its command buffer
+        float                                           m_TimestampPeriod;      // Nanoseconds per timestamp tick
+        uint64_t                                        m_TimestampMask;        // The valid bits of a timestamp. 0 if they aren't supported
+        uint64_t                                        m_GpuTime;              // The GPU time (us) read since the last TakeGpuTime()
+        uint32_t                                        m_GpuTimeCount;
         uint64_t                                        m_FrameNumber;
+        uint64_t                                        m_CompletedFrameNumber; // All frames up to this one have completed on the GPU
         uint32_t                                        m_Width;
         uint32_t                                        m_Height;
         bool                                            m_DoFinalBlit;
+        bool                                            m_TextureTargetActive; // m_TextureRenderTarget is used for the next flush
+        bool                                            m_ForceAtomicMode;
+        rive::gpu::ShaderCompilationMode                m_ShaderCompilationMode;
+        char                                            m_DeviceName[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE];
     };
 
     IDefoldRiveRenderer* MakeDefoldRiveRendererVulkan()
@@ -70,7 +70,7 @@ namespace dmRive
             rive::gpu::RenderContext::FrameDescriptor copy = frameDescriptor;
 
             // rendering to a render target
-            if (!m_RenderToTexture)
+            if (!m_RenderToTexture && !m_TextureRenderTarget)
             {
                 copy.loadAction = rive::gpu::LoadAction::preserveRenderTarget;
             }
@@ -80,6 +80,12 @@ namespace dmRive
 
         void Flush() override
         {
+            if (m_TextureRenderTarget)
+            {
+                FlushTextureRenderTarget();
+                return;
+            }
+
             WGPUCommandEncoder wgpu_encoder;
 
             if (!m_RenderToTexture)
@@ -175,6 +181,73 @@ namespace dmRive
             m_TargetTexture = texture;
         }
 
+        void Submit() override
+        {
+            // Each frame is submitted when it is flushed
+        }
+
+        void SetFramesInFlight(uint32_t count) override
+        {
+            // The WebGPU submission is done by Rive and Defold
+        }
+
+        void SetForceAtomicMode(bool force_atomic) override
+        {
+            // Chosen per frame, with FrameDescriptor::disableRasterOrdering
+        }
+
+        bool SupportsAtomicModePerFrame() override
+        {
+            return true;
+        }
+
+        const char* GetDeviceName() override
+        {
+            // The browser doesn't reliably tell the adapter apart
+            return "WebGPU";
+        }
+
+        void SetShaderCompilationMode(rive::gpu::ShaderCompilationMode mode) override
+        {
+            // The WebGPU context has no shader compilation options
+        }
+
+        bool ClearRegion(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t clear_color) override
+        {
+            // Not implemented for WebGPU
+            return false;
+        }
+
+        bool SupportsClearRegion() override
+        {
+            return false;
+        }
+
+        bool TakeGpuTime(uint64_t* time, uint32_t* count) override
+        {
+            // Timestamp queries are an optional WebGPU feature, and not requested by Rive
+            *time = 0;
+            *count = 0;
+            return false;
+        }
+
+        bool SetTextureRenderTarget(dmGraphics::HRenderTarget render_target, uint32_t width, uint32_t height) override
+        {
+            dmGraphics::HTexture texture = dmGraphics::GetRenderTargetTexture(m_GraphicsContext, render_target, dmGraphics::BUFFER_TYPE_COLOR0_BIT);
+            if (texture == 0)
+            {
+                return false;
+            }
+
+            WGPUTexture     webgpu_texture      = dmGraphics::WebGPUGetTexture(m_GraphicsContext, texture);
+            WGPUTextureView webgpu_texture_view = dmGraphics::WebGPUGetTextureView(m_GraphicsContext, texture);
+
+            auto renderContextImpl = m_RenderContext->static_impl_cast<rive::gpu::RenderContextWebGPUImpl>();
+            m_TextureRenderTarget  = renderContextImpl->makeRenderTarget(wgpu::TextureFormat::RGBA8Unorm, width, height);
+            m_TextureRenderTarget->setTargetTextureView(wgpu::TextureView(webgpu_texture_view), wgpu::Texture(webgpu_texture));
+            return true;
+        }
+
         dmGraphics::HTexture GetBackingTexture() override
         {
             return m_BackingTexture;
@@ -264,8 +337,27 @@ namespace dmRive
         }
 
     private:
+        // Render targets are drawn outside of the Defold render pass, with their own command encoder
+        void FlushTextureRenderTarget()
+        {
+            WGPUCommandEncoder wgpu_encoder = wgpuDeviceCreateCommandEncoder(m_Device.Get(), 0);
+
+            m_RenderContext->flush({
+                .renderTarget = m_TextureRenderTarget.get(),
+                .externalCommandBuffer = (void*)(uintptr_t)wgpu_encoder
+            });
+
+            const WGPUCommandBuffer buffer = wgpuCommandEncoderFinish(wgpu_encoder, NULL);
+            wgpuQueueSubmit(m_Queue.Get(), 1, &buffer);
+            wgpuCommandBufferRelease(buffer);
+            wgpuCommandEncoderRelease(wgpu_encoder);
+
+            m_TextureRenderTarget = nullptr;
+        }
+
         std::unique_ptr<rive::gpu::RenderContext> m_RenderContext;
         rive::rcp<rive::gpu::RenderTargetWebGPU>  m_RenderTarget;
+        rive::rcp<rive::gpu::RenderTargetWebGPU>  m_TextureRenderTarget; // Only set for a single frame
         dmGraphics::HContext                      m_GraphicsContext;
         dmGraphics::HTexture                      m_TargetTexture;
         dmGraphics::HTexture                      m_BackingTexture;
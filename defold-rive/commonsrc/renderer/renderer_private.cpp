@@ -54,8 +54,13 @@ namespace dmRive
 
         uint32_t             m_LastWidth;
         uint32_t             m_LastHeight;
+        uint32_t             m_FrameId;         // Incremented for every frame flushed into the Rive render target
+        RenderMode           m_RenderMode;
+        bool                 m_ClockwiseFill;   // FrameDescriptor::clockwiseFillOverride
+        uint32_t             m_MsaaSamples;     // The number of samples in RENDER_MODE_MSAA
         uint8_t              m_LastDoFinalBlit : 1;
         uint8_t              m_FrameBegin : 1;
+        uint8_t              m_TargetFrame : 1; // The frame is drawn into a Defold render target
 
         ~DefoldRiveRenderer()
         {
@@ -85,7 +90,12 @@ namespace dmRive
             g_RiveRenderer->m_RenderMutex     = 0;
             g_RiveRenderer->m_LastWidth       = 0;
             g_RiveRenderer->m_LastHeight      = 0;
+            g_RiveRenderer->m_FrameId         = 0;
+            g_RiveRenderer->m_RenderMode      = RENDER_MODE_RASTER_ORDERING;
+            g_RiveRenderer->m_ClockwiseFill   = false;
+            g_RiveRenderer->m_MsaaSamples     = 4;
             g_RiveRenderer->m_FrameBegin      = 0;
+            g_RiveRenderer->m_TargetFrame     = 0;
         }
 
         return (HRenderContext) g_RiveRenderer;
@@ -131,11 +141,8 @@ namespace dmRive
         return renderer->m_RenderContext->GetBackingTexture();
     }
 
-    void RenderBegin(HRenderContext context, dmResource::HFactory factory, const RenderBeginParams& params)
+    static void EnsureRenderer(DefoldRiveRenderer* renderer, dmResource::HFactory factory)
     {
-        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
-        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
-
         if (!renderer->m_RiveRenderer)
         {
             renderer->m_GraphicsContext = dmGraphics::GetInstalledContext();
@@ -143,20 +150,56 @@ namespace dmRive
             renderer->m_RiveRenderer = renderer->m_RenderContext->MakeRenderer();
             renderer->m_Factory = factory;
         }
+    }
+
+    static void SetFrameRenderMode(DefoldRiveRenderer* renderer, rive::gpu::RenderContext::FrameDescriptor& frame_descriptor)
+    {
+        frame_descriptor.disableRasterOrdering = renderer->m_RenderMode == RENDER_MODE_ATOMIC;
+        frame_descriptor.msaaSampleCount       = renderer->m_RenderMode == RENDER_MODE_MSAA ? renderer->m_MsaaSamples : 0;
+        frame_descriptor.clockwiseFillOverride = renderer->m_ClockwiseFill;
+    }
+
+    static void PrepareFrame(DefoldRiveRenderer* renderer, const RenderBeginParams& params)
+    {
+        uint32_t width = params.m_Width != 0 ? params.m_Width : dmGraphics::GetWindowWidth(renderer->m_GraphicsContext);
+        uint32_t height = params.m_Height != 0 ? params.m_Height : dmGraphics::GetWindowHeight(renderer->m_GraphicsContext);
+
+        if (width != renderer->m_LastWidth || height != renderer->m_LastHeight || renderer->m_LastDoFinalBlit != params.m_DoFinalBlit)
+        {
+            dmLogInfo("Change size to %d, %d", width, height);
+            renderer->m_RenderContext->OnSizeChanged(width, height, params.m_BackbufferSamples, params.m_DoFinalBlit);
+            renderer->m_LastWidth  = width;
+            renderer->m_LastHeight = height;
+            renderer->m_LastDoFinalBlit = params.m_DoFinalBlit;
+        }
+    }
+
+    void RenderPrepare(HRenderContext context, dmResource::HFactory factory, const RenderBeginParams& params)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+
+        EnsureRenderer(renderer, factory);
 
         if (!renderer->m_FrameBegin)
         {
-            uint32_t width = params.m_Width != 0 ? params.m_Width : dmGraphics::GetWindowWidth(renderer->m_GraphicsContext);
-            uint32_t height = params.m_Height != 0 ? params.m_Height : dmGraphics::GetWindowHeight(renderer->m_GraphicsContext);
+            PrepareFrame(renderer, params);
+        }
+    }
 
-            if (width != renderer->m_LastWidth || height != renderer->m_LastHeight || renderer->m_LastDoFinalBlit != params.m_DoFinalBlit)
-            {
-                dmLogInfo("Change size to %d, %d", width, height);
-                renderer->m_RenderContext->OnSizeChanged(width, height, params.m_BackbufferSamples, params.m_DoFinalBlit);
-                renderer->m_LastWidth  = width;
-                renderer->m_LastHeight = height;
-                renderer->m_LastDoFinalBlit = params.m_DoFinalBlit;
-            }
+    bool RenderBegin(HRenderContext context, dmResource::HFactory factory, const RenderBeginParams& params)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+
+        EnsureRenderer(renderer, factory);
+
+        bool region_only = false;
+        if (!renderer->m_FrameBegin)
+        {
+            PrepareFrame(renderer, params);
+            uint32_t width = renderer->m_LastWidth;
+            uint32_t height = renderer->m_LastHeight;
 
             int samples = (int) params.m_DoFinalBlit ? 0 : params.m_BackbufferSamples;
             (void)samples;
@@ -170,21 +213,75 @@ namespace dmRive
             }
         #endif
 
+            // The size may just have changed, in which case the last frame is gone
+            if (params.m_RegionWidth != 0 && params.m_RegionHeight != 0 && params.m_DoFinalBlit &&
+                params.m_RegionX + params.m_RegionWidth <= width && params.m_RegionY + params.m_RegionHeight <= height)
+            {
+                region_only = renderer->m_RenderContext->ClearRegion(params.m_RegionX, params.m_RegionY, params.m_RegionWidth, params.m_RegionHeight, params.m_ClearColor);
+            }
 
-            renderer->m_RenderContext->BeginFrame({
+            rive::gpu::RenderContext::FrameDescriptor frame_descriptor = {
                 .renderTargetWidth      = width,
                 .renderTargetHeight     = height,
                 .clearColor             = params.m_ClearColor,
-                .msaaSampleCount        = 0,
-                // .msaaSampleCount        = samples,
-                // .disableRasterOrdering  = s_forceAtomicMode,
                 // .wireframe              = s_wireframe,
                 // .fillsDisabled          = s_disableFill,
                 // .strokesDisabled        = s_disableStroke,
-            });
+            };
+            SetFrameRenderMode(renderer, frame_descriptor);
+            if (region_only)
+            {
+                frame_descriptor.loadAction = rive::gpu::LoadAction::preserveRenderTarget;
+            }
+            renderer->m_RenderContext->BeginFrame(frame_descriptor);
 
             renderer->m_FrameBegin = 1;
         }
+        return region_only;
+    }
+
+    bool RenderBeginTarget(HRenderContext context, dmResource::HFactory factory, dmGraphics::HRenderTarget render_target, uint32_t clear_color, bool preserve, uint32_t* width, uint32_t* height)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+
+        if (renderer->m_FrameBegin)
+        {
+            return false;
+        }
+
+        EnsureRenderer(renderer, factory);
+
+        dmGraphics::HTexture texture = dmGraphics::GetRenderTargetTexture(renderer->m_GraphicsContext, render_target, dmGraphics::BUFFER_TYPE_COLOR0_BIT);
+        if (texture == 0)
+        {
+            return false;
+        }
+
+        uint32_t target_width = dmGraphics::GetTextureWidth(renderer->m_GraphicsContext, texture);
+        uint32_t target_height = dmGraphics::GetTextureHeight(renderer->m_GraphicsContext, texture);
+        if (target_width == 0 || target_height == 0 || !renderer->m_RenderContext->SetTextureRenderTarget(render_target, target_width, target_height))
+        {
+            return false;
+        }
+
+        rive::gpu::RenderContext::FrameDescriptor frame_descriptor = {
+            .renderTargetWidth      = target_width,
+            .renderTargetHeight     = target_height,
+            .clearColor             = clear_color,
+        };
+        SetFrameRenderMode(renderer, frame_descriptor);
+        if (preserve)
+        {
+            frame_descriptor.loadAction = rive::gpu::LoadAction::preserveRenderTarget;
+        }
+        renderer->m_RenderContext->BeginFrame(frame_descriptor);
+
+        renderer->m_FrameBegin = 1;
+        renderer->m_TargetFrame = 1;
+        *width = target_width;
+        *height = target_height;
+        return true;
     }
 
     void GetDimensions(HRenderContext context, uint32_t* width, uint32_t* height)
@@ -200,7 +297,74 @@ namespace dmRive
         renderer->m_RenderMutex = mutex;
     }
 
-    void RenderEnd(HRenderContext context)
+    void SetRenderMode(HRenderContext context, RenderMode mode, uint32_t msaa_samples)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+        renderer->m_RenderMode = mode;
+        renderer->m_MsaaSamples = msaa_samples;
+        renderer->m_RenderContext->SetForceAtomicMode(mode == RENDER_MODE_ATOMIC);
+    }
+
+    RenderMode GetRenderMode(HRenderContext context)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        return renderer->m_RenderMode;
+    }
+
+    void SetClockwiseFillOverride(HRenderContext context, bool clockwise_fill)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+        renderer->m_ClockwiseFill = clockwise_fill;
+    }
+
+    bool CanSwitchRenderMode(HRenderContext context, RenderMode mode)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        return mode != RENDER_MODE_ATOMIC || renderer->m_RenderContext->SupportsAtomicModePerFrame();
+    }
+
+    const char* GetDeviceName(HRenderContext context)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        return renderer->m_RenderContext->GetDeviceName();
+    }
+
+    bool SupportsPartialRedraw(HRenderContext context)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        return renderer->m_RenderContext->SupportsClearRegion();
+    }
+
+    bool TakeGpuTime(HRenderContext context, uint64_t* time, uint32_t* count)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+        return renderer->m_RenderContext->TakeGpuTime(time, count);
+    }
+
+    void SetShaderCompilation(HRenderContext context, ShaderCompilation mode)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        rive::gpu::ShaderCompilationMode rive_mode = rive::gpu::ShaderCompilationMode::allowAsynchronous;
+        switch (mode)
+        {
+            case SHADER_COMPILATION_ASYNC:       rive_mode = rive::gpu::ShaderCompilationMode::allowAsynchronous; break;
+            case SHADER_COMPILATION_SYNC:        rive_mode = rive::gpu::ShaderCompilationMode::alwaysSynchronous; break;
+            case SHADER_COMPILATION_UBERSHADERS: rive_mode = rive::gpu::ShaderCompilationMode::onlyUbershaders; break;
+        }
+        renderer->m_RenderContext->SetShaderCompilationMode(rive_mode);
+    }
+
+    void SetFramesInFlight(HRenderContext context, uint32_t count)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+        renderer->m_RenderContext->SetFramesInFlight(count);
+    }
+
+    void RenderEnd(HRenderContext context, bool submit)
     {
         DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
 
@@ -208,10 +372,29 @@ namespace dmRive
         {
             DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
             renderer->m_RenderContext->Flush();
+            if (submit)
+            {
+                renderer->m_RenderContext->Submit();
+            }
+            renderer->m_FrameId += renderer->m_TargetFrame ? 0 : 1;
             renderer->m_FrameBegin = 0;
+            renderer->m_TargetFrame = 0;
         }
     }
 
+    void RenderSubmit(HRenderContext context)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        DM_MUTEX_OPTIONAL_SCOPED_LOCK(renderer->m_RenderMutex);
+        renderer->m_RenderContext->Submit();
+    }
+
+    uint32_t GetFrameId(HRenderContext context)
+    {
+        DefoldRiveRenderer* renderer = (DefoldRiveRenderer*) context;
+        return renderer->m_FrameId;
+    }
+
     static void RepackLuminanceToRGBA(uint32_t num_pixels, uint8_t* luminance, uint8_t* rgba)
     {
         for(uint32_t px=0; px < num_pixels; px++)
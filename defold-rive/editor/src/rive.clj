@@ -189,6 +189,16 @@
   "The name of the initial state machine of the selected artboard. If empty, uses the default state machine.")
 (def ^:private auto-bind-tooltip
   "If true, the default viewmodel for the artboard will be used.\nIf false, scripting needs to set this up.")
+(def ^:private prewarm-artboards-tooltip
+  "Comma separated names of the artboards to instantiate when the scene is loaded.\nIf empty, uses the default artboard.")
+(def ^:private prewarm-state-machine-tooltip
+  "The name of the state machine to instantiate with the prewarmed artboards.\nIf empty, uses the default state machine.")
+(def ^:private prewarm-count-tooltip
+  "The number of instances per artboard to create when the scene is loaded.\nThey are used by the first Rive models created with the same artboard and state machine.")
+(def ^:private update-rate-tooltip
+  "The number of times per second the state machine is advanced.\nIf 0, it is advanced every frame.")
+(def ^:private shared-instance-tooltip
+  "If true, all models in the collection with the same scene, artboard and state machine\nuse one instance, which is advanced once per frame and drawn at each model's transform.")
 
 (defn- string-or [value fallback]
   (if (and (string? value) (not (str/blank? value)))
@@ -273,6 +283,8 @@
         artboard :artboard
         default-state-machine :default-state-machine
         auto-bind :auto-bind
+        update-rate :update-rate
+        shared-instance :shared-instance
         coordinate-system :coordinate-system
         artboard-fit :artboard-fit
         artboard-alignment :artboard-alignment))))
@@ -592,10 +604,13 @@
 ; .rivescene (The "data" file) which in turn points to the .riv file
 
 ; Node defs
-(g/defnk produce-rivescene-save-value [rive-file-resource]
+(g/defnk produce-rivescene-save-value [rive-file-resource prewarm-artboards prewarm-state-machine prewarm-count]
   ; rive-file-resource may be nil if the :scene isn't set (as seen in the template.rivescene)
   (protobuf/make-map-without-defaults rive-scene-pb-class
-    :scene (resource/resource->proj-path rive-file-resource)))
+    :scene (resource/resource->proj-path rive-file-resource)
+    :prewarm-artboards prewarm-artboards
+    :prewarm-state-machine prewarm-state-machine
+    :prewarm-count prewarm-count))
 
 (defn- prop-resource-error [_node-id prop-kw prop-value prop-name]
   (validation/prop-error :fatal _node-id prop-kw validation/prop-resource-missing? prop-value prop-name))
@@ -637,8 +652,11 @@
                                          :dep-resources dep-resources}
                              :deps dep-build-targets})])))
 
-(g/defnk produce-rivescene-pb [_node-id rive-file-resource]
-  {:scene (resource/resource->proj-path rive-file-resource)})
+(g/defnk produce-rivescene-pb [_node-id rive-file-resource prewarm-artboards prewarm-state-machine prewarm-count]
+  {:scene (resource/resource->proj-path rive-file-resource)
+   :prewarm-artboards prewarm-artboards
+   :prewarm-state-machine prewarm-state-machine
+   :prewarm-count prewarm-count})
 
 (defn- renderable->handle [renderable]
   (get-in renderable [:user-data :rive-file-handle]))
@@ -992,6 +1010,17 @@
             (dynamic label (g/constantly "Bounds"))
             (dynamic read-only? (g/constantly true)))
 
+  (property prewarm-artboards g/Str (default (protobuf/default rive-scene-pb-class :prewarm-artboards))
+            (dynamic tooltip (g/constantly prewarm-artboards-tooltip)))
+
+  (property prewarm-state-machine g/Str (default (protobuf/default rive-scene-pb-class :prewarm-state-machine))
+            (dynamic tooltip (g/constantly prewarm-state-machine-tooltip)))
+
+  (property prewarm-count g/Int (default (protobuf/default rive-scene-pb-class :prewarm-count))
+            (dynamic tooltip (g/constantly prewarm-count-tooltip))
+            (dynamic error (g/fnk [_node-id prewarm-count]
+                             (validation/prop-error :fatal _node-id :prewarm-count validation/prop-negative? prewarm-count "Prewarm Count"))))
+
   ;; This property isn't visible, but here to allow us to preview the .rivescene
   (property material resource/Resource ; Default assigned in load-fn.
             (set (fn [evaluation-context self old-value new-value]
@@ -1049,7 +1078,10 @@
       (g/set-property self :material (resolve-resource editor-blit-material-proj-path))
       (g/set-property self :selection-material (resolve-resource selection-material-proj-path))
       (gu/set-properties-from-pb-map self rive-scene-pb-class rive-scene-desc
-        rive-file (resolve-resource :scene)))))
+        rive-file (resolve-resource :scene)
+        prewarm-artboards :prewarm-artboards
+        prewarm-state-machine :prewarm-state-machine
+        prewarm-count :prewarm-count))))
 
 
 ;
@@ -1120,13 +1152,15 @@
             texture-version (render-settings->texture-version artboard state-machine fit-int alignment-int)]
         (rive-texture->gpu-texture node-id texture default-tex-params texture-version)))))
 
-(g/defnk produce-rivemodel-save-value [rive-scene-resource artboard default-state-machine blit-material-resource auto-bind coordinate-system artboard-fit artboard-alignment]
+(g/defnk produce-rivemodel-save-value [rive-scene-resource artboard default-state-machine blit-material-resource auto-bind update-rate shared-instance coordinate-system artboard-fit artboard-alignment]
   (protobuf/make-map-without-defaults rive-model-pb-class
     :scene (resource/resource->proj-path rive-scene-resource)
     :blit-material (resource/resource->proj-path blit-material-resource)
     :artboard artboard
     :default-state-machine default-state-machine
     :auto-bind auto-bind
+    :update-rate update-rate
+    :shared-instance shared-instance
     :coordinate-system coordinate-system
     :artboard-fit artboard-fit
     :artboard-alignment artboard-alignment))
@@ -1242,6 +1276,14 @@
   (property auto-bind g/Bool (default (protobuf/default rive-model-pb-class :auto-bind))
             (dynamic tooltip (g/constantly auto-bind-tooltip)))
 
+  (property update-rate g/Num (default (protobuf/default rive-model-pb-class :update-rate))
+            (dynamic tooltip (g/constantly update-rate-tooltip))
+            (dynamic error (g/fnk [_node-id update-rate]
+                             (validation/prop-error :fatal _node-id :update-rate validation/prop-negative? update-rate "Update Rate"))))
+
+  (property shared-instance g/Bool (default (protobuf/default rive-model-pb-class :shared-instance))
+            (dynamic tooltip (g/constantly shared-instance-tooltip)))
+
   (property coordinate-system g/Any (default (protobuf/default rive-model-pb-class :coordinate-system))
             (dynamic tooltip (g/constantly "Rive: Uses a fullscreen quad for rendering\nGame: Uses the game object transform."))
             (dynamic edit-type (g/constantly coordinate-system-edit-type)))
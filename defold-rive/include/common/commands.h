@@ -23,23 +23,42 @@ namespace rive
 
 namespace dmRiveCommands
 {
+    // Monotonically increasing. A signaled fence implies that all earlier fences are signaled
+    typedef uint32_t FenceId;
+
     enum Result
     {
         RESULT_OK = 0,
         RESULT_FAILED_CREATE_THREAD = -1,
     };
 
+    enum AdvanceResult
+    {
+        ADVANCE_RESULT_ADVANCED = 1,    // The state machine was found and advanced
+        ADVANCE_RESULT_SETTLED  = 2,    // The state machine has nothing more to animate
+        ADVANCE_RESULT_DEFERRED = 4,    // The time budget ran out before the state machine was advanced
+    };
+
+    struct AdvanceEntry
+    {
+        rive::StateMachineHandle    m_StateMachine;
+        float                       m_DeltaTime;
+        uint32_t                    m_Result;       // AdvanceResult flags. Written by the command server
+    };
+
     struct InitParams
     {
         dmRive::HRenderContext  m_RenderContext;
         rive::Factory*          m_Factory;
         dmMutex::HMutex         m_Mutex;
+        uint32_t                m_SpinTime;     // Time (us) the command thread keeps polling for work before it parks
         bool                    m_UseThreads;
 
         InitParams()
         : m_RenderContext(0)
         , m_Factory(0)
         , m_Mutex(0)
+        , m_SpinTime(0)
         , m_UseThreads(false)
         {}
     };
@@ -47,9 +66,29 @@ namespace dmRiveCommands
     Result Initialize(InitParams* params); // Once per session
     Result Finalize();   // Once per session
 
+    // Fences the command server and delivers all pending messages
     Result ProcessMessages();
+    // Wakes the command server and delivers pending messages. When running threaded, it doesn't wait for the command server
+    Result PollMessages();
+    // Wakes the command thread to process the commands queued so far.
+    // Commands that are queued without a kick are processed at the next kick or fence.
+    void Kick();
+    // True if the command server runs on its own thread
+    bool IsThreaded();
+
+    // Fences are executed by the command server after all previously queued commands
+    FenceId InsertFence();
+    bool IsFenceSignaled(FenceId fence);
+    // Blocks until the fence is signaled. Doesn't deliver any messages
+    void WaitFence(FenceId fence);
     bool WaitUntil(bool (*condition)(void*), void* user_data, uint64_t timeout);
 
+    // Advances all state machines in a single command. The entries are owned by the caller, and
+    // they must be kept alive and left untouched until the returned fence is signaled.
+    // If budget (us) is non zero, the entries left when it has run out are marked as deferred.
+    // The first entry is always advanced.
+    FenceId AdvanceStateMachines(AdvanceEntry* entries, uint32_t count, uint32_t budget);
+
     // Getters
     rive::Factory*                  GetFactory();
     dmRive::HRenderContext          GetDefoldRenderContext();
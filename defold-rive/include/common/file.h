@@ -119,6 +119,12 @@ namespace dmRive
                                   const rive::Mat2D& game_transform,
                                   float display_factor,
                                   float window_height);
+    // Same as above, for when only the artboard bounds are known
+    rive::Mat2D CalcTransformGame(const rive::AABB& bounds,
+                                  const rive::Mat2D& view_transform,
+                                  const rive::Mat2D& game_transform,
+                                  float display_factor,
+                                  float window_height);
 
     bool DrawArtboard(rive::ArtboardInstance* artboard,
                       rive::Renderer* renderer,
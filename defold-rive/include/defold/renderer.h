@@ -35,6 +35,23 @@ namespace dmRive
 {
     typedef void*  HRenderContext;
 
+    // How the Rive renderer resolves overlapping paths
+    enum RenderMode
+    {
+        RENDER_MODE_RASTER_ORDERING, // Raster ordering where supported, otherwise atomic. The Rive default
+        RENDER_MODE_ATOMIC,
+        RENDER_MODE_MSAA,
+        RENDER_MODE_COUNT,
+    };
+
+    // How the Rive shaders are compiled the first time they are needed
+    enum ShaderCompilation
+    {
+        SHADER_COMPILATION_ASYNC,       // Draws with a general shader while the specialized one compiles in the background
+        SHADER_COMPILATION_SYNC,        // Waits for the specialized shader, which can cause a hitch when new content is first drawn
+        SHADER_COMPILATION_UBERSHADERS, // Only uses the general shaders, which are slower to draw with
+    };
+
     struct RenderBeginParams
     {
         bool     m_DoFinalBlit = true;
@@ -42,6 +59,11 @@ namespace dmRive
         uint32_t m_Width = 0;
         uint32_t m_Height = 0;
         uint32_t m_ClearColor = 0;
+        // If set, only this region (in pixels, from the top left) is cleared, and the rest of the last frame is kept
+        uint32_t m_RegionX = 0;
+        uint32_t m_RegionY = 0;
+        uint32_t m_RegionWidth = 0;
+        uint32_t m_RegionHeight = 0;
     };
 
     HRenderContext               NewRenderContext();
@@ -53,10 +75,42 @@ namespace dmRive
     rive::Mat2D                  GetViewProjectionTransform(HRenderContext context, dmRender::HRenderContext render_context);
     void                         GetDimensions(HRenderContext context, uint32_t* width, uint32_t* height);
     void                         SetRenderMutex(HRenderContext context, dmMutex::HMutex mutex);
-    void                         RenderBegin(HRenderContext context, dmResource::HFactory factory, const RenderBeginParams& params);
-    void                         RenderEnd(HRenderContext context);
+    // Takes effect with the next frame. Whether atomic mode is forced for the whole context is only decided
+    // if this is called before the Rive render context is created
+    void                         SetRenderMode(HRenderContext context, RenderMode mode, uint32_t msaa_samples);
+    RenderMode                   GetRenderMode(HRenderContext context);
+    // Draws all paths with the clockwise fill rule, whatever fill rule they have, like Rive's clockwise atomic mode.
+    // It changes how content authored with other fill rules is drawn, so it isn't one of the render modes
+    void                         SetClockwiseFillOverride(HRenderContext context, bool clockwise_fill);
+    // Whether the mode can be switched to while running, and draws differently from the others
+    bool                         CanSwitchRenderMode(HRenderContext context, RenderMode mode);
+    // The name of the GPU, once the Rive render context has been created. Empty if unknown
+    const char*                  GetDeviceName(HRenderContext context);
+    // Whether RenderBegin() can redraw a region of the last frame. Otherwise the whole frame is always drawn
+    bool                         SupportsPartialRedraw(HRenderContext context);
+    // The GPU time (us) of the Rive frames that finished since the last call, and how many there were. They finish a frame
+    // or more after they were submitted. Returns false if this graphics backend or device can't measure it
+    bool                         TakeGpuTime(HRenderContext context, uint64_t* time, uint32_t* count);
+    // Only used if called before the Rive render context is created
+    void                         SetShaderCompilation(HRenderContext context, ShaderCompilation mode);
+    // The number of Rive frames the CPU may record ahead of the GPU (Vulkan only)
+    void                         SetFramesInFlight(HRenderContext context, uint32_t count);
+    // Resizes the Rive render target, if needed, without beginning a frame
+    void                         RenderPrepare(HRenderContext context, dmResource::HFactory factory, const RenderBeginParams& params);
+    // Returns true if only the region of the params is cleared, and the rest of the last frame is kept
+    bool                         RenderBegin(HRenderContext context, dmResource::HFactory factory, const RenderBeginParams& params);
+    // If submit isn't set, the frame is submitted to the GPU together with the next one that is, or by RenderSubmit.
+    // Only the backends that do their own submission (Vulkan) batch them, the others always submit each frame
+    void                         RenderEnd(HRenderContext context, bool submit = true);
+    // Submits the frames ended without submitting them. Must be called before Defold submits the frame that uses them
+    void                         RenderSubmit(HRenderContext context);
+    // Begins a frame drawn into the first color attachment of a Defold render target, instead of the Rive render target.
+    // The target is cleared, unless preserve is set and the contents are kept. It is ended with RenderEnd, and can't be begun while another frame is.
+    bool                         RenderBeginTarget(HRenderContext context, dmResource::HFactory factory, dmGraphics::HRenderTarget render_target, uint32_t clear_color, bool preserve, uint32_t* width, uint32_t* height);
 
     dmGraphics::HTexture         GetBackingTexture(HRenderContext context);
+    // Changes every time a frame is drawn into the Rive render target, so a caller can tell if it still holds its last frame
+    uint32_t                     GetFrameId(HRenderContext context);
 }
 
 #endif /* DM_RIVE_RENDERER_H */
@@ -13,6 +13,7 @@
 #if !defined(DM_RIVE_UNSUPPORTED)
 
 #include <string.h> // memset
+#include <algorithm> // std::sort
 
 // Rive extension
 #include "comp_rive.h"
@@ -40,6 +41,7 @@
 #include <dmsdk/dlib/math.h>
 #include <dmsdk/dlib/object_pool.h>
 #include <dmsdk/dlib/profile.h>
+#include <dmsdk/dlib/time.h>
 #include <dmsdk/gameobject/component.h>
 #include <dmsdk/gameobject/gameobject.h>
 #include <dmsdk/gamesys/property.h>
@@ -54,6 +56,7 @@
 #include <dmsdk/gamesys/resources/res_animationset.h>
 #include <dmsdk/gamesys/resources/res_textureset.h>
 #include <dmsdk/gamesys/resources/res_material.h>
+#include <dmsdk/gamesys/resources/res_render_target.h>
 
 // Not in dmSDK yet
 namespace dmScript
@@ -62,8 +65,21 @@ namespace dmScript
     void PushURL(lua_State* L, const dmMessage::URL& m);
 }
 
+DM_PROPERTY_EXTERN(rmtp_RiveFences); // commonsrc/commands.cpp
+DM_PROPERTY_U32(rmtp_RiveFencesPerFrame, 0, PROFILE_PROPERTY_FRAME_RESET, "# fences", &rmtp_RiveFences);
+
 DM_PROPERTY_GROUP(rmtp_Rive, "Rive", 0);
 DM_PROPERTY_U32(rmtp_RiveComponents, 0, PROFILE_PROPERTY_FRAME_RESET, "# rive components", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveComponentsPeak, 0, PROFILE_PROPERTY_FRAME_RESET, "# rive components (high water mark)", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveCulled, 0, PROFILE_PROPERTY_FRAME_RESET, "# culled components", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveSleeping, 0, PROFILE_PROPERTY_FRAME_RESET, "# sleeping components", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveDeferred, 0, PROFILE_PROPERTY_FRAME_RESET, "# deferred advances", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveRenderTargets, 0, PROFILE_PROPERTY_FRAME_RESET, "# render target draws", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveFrameCacheHits, 0, PROFILE_PROPERTY_FRAME_RESET, "# frames reused from the frame cache", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RivePartialFrames, 0, PROFILE_PROPERTY_FRAME_RESET, "# partially redrawn frames", &rmtp_Rive);
+DM_PROPERTY_F32(rmtp_RiveResolutionScale, 1.0f, PROFILE_PROPERTY_NONE, "Rive render target scale", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveFrameCacheMisses, 0, PROFILE_PROPERTY_FRAME_RESET, "# frames redrawn with the frame cache enabled", &rmtp_Rive);
+DM_PROPERTY_U32(rmtp_RiveGpuTime, 0, PROFILE_PROPERTY_NONE, "Rive GPU time (us)", &rmtp_Rive);
 
 namespace dmRive
 {
@@ -72,15 +88,104 @@ namespace dmRive
     static const dmhash_t PROP_ARTBOARD         = dmHashString64("artboard");
     static const dmhash_t PROP_STATE_MACHINE    = dmHashString64("state_machine");
     static const dmhash_t PROP_PLAYBACK_RATE    = dmHashString64("playback_rate");
+    static const dmhash_t PROP_UPDATE_RATE      = dmHashString64("update_rate");
     static const dmhash_t PROP_MATERIAL         = dmHashString64("material");
     static const dmhash_t MATERIAL_EXT_HASH     = dmHashString64("materialc");
     static const dmhash_t PROP_RIVE_FILE        = dmHashString64("rive_file");
+    static const dmhash_t PROP_RENDER_TARGET    = dmHashString64("render_target");
+    static const dmhash_t RENDER_TARGET_EXT_HASH = dmHashString64("render_targetc");
 
     static float g_DisplayFactor = 0.0f;
+    static uint32_t g_WakeGeneration = 0;
     static RenderBeginParams g_RenderBeginParams;
+    // Set by the render script to draw the Rive pass straight into a render target, without the blit. 0 if not set.
+    // It is kept until it is changed, since it is read when the buffered render.draw() calls are executed
+    static dmGraphics::HRenderTarget g_RenderTarget = 0;
+
+    // The size of the Rive render target relative to the window, when rendering to texture.
+    // The blit upscales it to the window.
+    struct ResolutionScaling
+    {
+        float                    m_Scale;      // The current scale
+        float                    m_MaxScale;   // The static scale, and the upper limit of the dynamic scale
+        float                    m_MinScale;   // The lower limit of the dynamic scale
+        uint64_t                 m_TargetTime; // The Rive render time (us) per frame to keep below. 0 disables the dynamic scale. See TakeFrameRenderTime()
+        uint64_t                 m_RenderTime; // The Rive render time (us) since the last adjustment
+        uint32_t                 m_FrameCount; // The number of frames since the last adjustment
+    };
+
+    static ResolutionScaling g_Resolution = { 1.0f, 1.0f, 1.0f, 0, 0, 0 };
+
+    // The dynamic scale is adjusted at most this often, in frames, since every change reallocates the render target
+    static const uint32_t RESOLUTION_SAMPLE_FRAMES = 30;
+    static const float    RESOLUTION_SCALE_STEP    = 0.05f;
+    // The scale is kept while the render time is between this fraction of the target time and the target time
+    static const float    RESOLUTION_HEADROOM      = 0.75f;
+
+    // The CPU time (us) and count of the Rive frames rendered since the last TakeFrameRenderTime()
+    static uint64_t g_FrameCpuTime = 0;
+    static uint32_t g_FrameCpuCount = 0;
+
+    // The Rive render time of the last frame, see TakeFrameRenderTime()
+    struct FrameRenderTime
+    {
+        uint64_t m_Time;  // us
+        uint32_t m_Count; // The number of Rive frames measured. 0 if none
+        bool     m_Gpu;   // Measured on the GPU. Otherwise on the CPU, without the GPU work
+    };
+
+    static FrameRenderTime g_FrameRenderTime = { 0, 0, false };
+    // Every Rive frame is drawn in full, without reusing the last one. Set while the render modes are timed
+    static bool g_ForceFullRedraw = false;
+
+    struct WarmUpRequest
+    {
+        WarmUpCallback m_Callback;
+        void*          m_UserData;
+        bool           m_WarmedUp;
+    };
+
+    // Artboards waiting to be drawn by RenderWarmUp(), and the requests waiting for CompRiveUpdateWarmUp() to call their callbacks
+    struct WarmUp
+    {
+        dmArray<RiveArtboardInstance>   m_Artboards;
+        dmArray<WarmUpRequest>          m_Requests;
+        dmArray<WarmUpRequest>          m_Done;
+        rive::DrawKey                   m_DrawKey;
+        rive::CommandServerDrawCallback m_DrawCallback;
+        rive::Renderer*                 m_Renderer;
+        uint32_t                        m_Width;
+        uint32_t                        m_Height;
+    };
+
+    static WarmUp g_WarmUp;
+
+    // The components are woken by the handles they use. A handle is tagged with its type, since the handle types are counted separately
+    enum WakeHandleType
+    {
+        WAKE_HANDLE_STATE_MACHINE       = 0,
+        WAKE_HANDLE_VIEW_MODEL_INSTANCE = 1,
+    };
+
+    // A request is kept for two frames, so that every world sees it in its next update,
+    // whether it runs before or after the script that made it
+    struct WakeRequests
+    {
+        dmHashTable64<uint64_t> m_Links;        // Wake key -> the wake key of what it is bound to, or nested in
+        dmHashTable64<uint8_t>  m_Requests[2];  // The wake keys requested in this frame, and in the previous one
+        uint32_t                m_Current;
+    };
+
+    static WakeRequests g_WakeRequests;
+    // Links are followed this deep, e.g. a list item of a nested view model instance of one bound to a state machine
+    static const uint32_t MAX_WAKE_LINK_DEPTH = 8;
+    // For the per frame updates called by the extension
+    static struct CompRiveContext* g_Context = 0;
 
     static void ResourceReloadedCallback(const dmResource::ResourceReloadedParams* params);
     static void DestroyComponent(struct RiveWorld* world, uint32_t index);
+    static void ProcessAdvanceResults(struct RiveWorld* world);
+    static void ApplyWakeRequests(struct RiveWorld* world);
     static void CompRiveAnimationReset(RiveComponent* component);
 
     // For the entire app's life cycle
@@ -95,7 +200,60 @@ namespace dmRive
         dmGraphics::HContext     m_GraphicsContext;
         dmGraphics::HTexture     m_NullTexture;
         HRenderContext           m_RiveRenderContext;
-        uint32_t                 m_MaxInstanceCount;
+        uint32_t                 m_MaxInstanceCount;        // Per world. 0 means unlimited
+        uint32_t                 m_AdvanceBudget;           // Time (us) per world and frame for advancing state machines. 0 means unlimited
+        float                    m_LodScreenSize;           // Components smaller than this (pixels) are advanced at m_LodUpdateRate
+        float                    m_LodUpdateRate;
+        uint8_t                  m_Culling : 1;             // Skip drawing components outside of the render target
+        uint8_t                  m_CullingPauseAdvance : 1; // Also stop advancing the culled components
+        uint8_t                  m_SleepSettled : 1;        // Stop advancing settled state machines until they're woken
+        uint8_t                  m_FrameCache : 1;          // Reuse the last frame of a world when nothing in it changed
+        uint8_t                  m_PartialRedraw : 1;       // Only redraw the changed part of the last frame of a world
+    };
+
+    // Per component draw parameters, uploaded to the command server once per frame
+    struct RiveDrawParams
+    {
+        rive::Mat2D             m_WorldTransform;
+        rive::Mat2D             m_InverseRendererTransform; // Written by the command server
+        rive::AABB              m_Bounds;                   // Written by the command server
+        rive::AABB              m_ScreenBounds;             // The render target pixels it covers, if m_HasScreenBounds
+        RiveComponent*          m_Component;
+        rive::ArtboardHandle    m_Artboard;
+        rive::Fit               m_Fit;
+        rive::Alignment         m_Alignment;
+        uint8_t                 m_CoordGame : 1;
+        uint8_t                 m_Drawn : 1;                // Written by the command server
+        uint8_t                 m_HasScreenBounds : 1;
+        uint8_t                 m_Clips : 1;                // Written by the command server. Nothing is drawn outside of m_Bounds
+        uint8_t                 : 4;
+    };
+
+    // Shared by all components drawn in a frame
+    struct RiveDrawFrameParams
+    {
+        rive::Renderer*         m_Renderer;
+        rive::AABB              m_ClipRect;                 // If m_HasClipRect, all drawing is clipped to it
+        rive::Mat2D             m_ViewTransform;
+        uint32_t                m_Width;
+        uint32_t                m_Height;
+        uint32_t                m_WindowHeight;
+        float                   m_DisplayFactor;
+        float                   m_ResolutionScale;          // Render target pixels per window pixel
+        bool                    m_FlipY;                    // For render targets sampled with the OpenGL texture orientation
+        bool                    m_HasClipRect;
+    };
+
+    // The artboard, state machine and view model instance of components with the shared instance option.
+    // It is advanced once per frame, and drawn once for each component.
+    struct RiveSharedInstance
+    {
+        dmhash_t                        m_Key;
+        rive::ArtboardHandle            m_Artboard;
+        rive::StateMachineHandle        m_StateMachine;
+        rive::ViewModelInstanceHandle   m_ViewModelInstance;
+        uint32_t                        m_RefCount;
+        uint32_t                        m_UpdateToken;  // The world update it was last advanced in
     };
 
     // One per collection
@@ -103,12 +261,42 @@ namespace dmRive
     {
         CompRiveContext*                        m_Ctx;
         HRenderContext                          m_RiveRenderContext;
-        dmObjectPool<RiveComponent*>            m_Components;
-        dmArray<dmRender::RenderObject>         m_RenderObjects;
-        dmArray<dmRender::HNamedConstantBuffer> m_RenderConstants; // 1:1 mapping with the render objects
+        // Contiguous, and compacted when a component is freed. The components move on Free() and SetCapacity(),
+        // so only the pool indices (the component user data) may be kept across them, never a RiveComponent*.
+        // Pointers are only kept within a frame: m_AdvanceComponents until ProcessAdvanceResults(),
+        // and the render list and m_DrawParams until the render of the frame is done.
+        dmObjectPool<RiveComponent>             m_Components;
+        dmArray<dmRender::RenderObject>         m_RenderObjects;   // The final blit. Never grown while in use by the renderer
+        uint32_t                                m_ComponentsHighWater;
+        uint32_t                                m_NextComponentId;
         dmGraphics::HVertexBuffer               m_BlitToBackbufferVertexBuffer;
         dmGraphics::HVertexDeclaration          m_VertexDeclaration;
         dmGameSystem::MaterialResource*         m_BlitMaterial;
+        dmArray<dmRiveCommands::AdvanceEntry>   m_AdvanceEntries;   // Read by the command server until m_AdvanceFence is signaled
+        dmArray<RiveComponent*>                 m_AdvanceComponents; // 1:1 mapping with the advance entries
+        dmRiveCommands::FenceId                 m_AdvanceFence;
+        // The draw callback is created once, and reads the draw parameters of the current frame
+        rive::DrawKey                           m_DrawKey;
+        rive::CommandServerDrawCallback         m_DrawCallback;
+        RiveDrawFrameParams                     m_DrawFrame;
+        dmArray<RiveDrawParams>                 m_DrawParams;      // Read/written by the command server until the render fence
+        rive::rcp<rive::RenderPath>             m_ClipPath;        // Rebuilt from m_DrawFrame.m_ClipRect by the command server
+        // Components with a render target are drawn one at a time, each in a frame of its own
+        rive::DrawKey                           m_TargetDrawKey;
+        rive::CommandServerDrawCallback         m_TargetDrawCallback;
+        RiveDrawFrameParams                     m_TargetDrawFrame;
+        RiveDrawParams                          m_TargetDrawParams;
+        dmHashTable64<RiveSharedInstance*>      m_SharedInstances;
+        uint32_t                                m_UpdateToken;     // Incremented every update
+        // The frame cache. The Rive render target still holds the last frame of this world if no other frame was drawn after it
+        uint64_t                                m_FrameSignature;  // Hash of everything the last frame was drawn from, except the poses
+        uint32_t                                m_FrameId;         // The renderer frame id after the last frame was drawn. 0 if none
+        bool                                    m_PoseChanged;     // A state machine may have changed its artboard since the last frame
+        // Partial redraws. The changed part of the render target since the last frame of this world
+        RiveDrawFrameParams                     m_DrawnFrame;      // The frame parameters of the last frame
+        rive::AABB                              m_DirtyRegion;     // Only valid if m_HasDirtyRegion
+        bool                                    m_HasDirtyRegion;
+        dmGraphics::HRenderTarget               m_DrawTarget;      // The render target the current frame is drawn into, if set with rive.set_render_target()
         bool                                    m_DidWork;         // did we get any batch workload ?
     };
 
@@ -161,6 +349,86 @@ namespace dmRive
         return rive::Alignment::center;
     }
 
+    // The clip path is only needed if the frame has a clip rect
+    static void DrawArtboards(const RiveDrawFrameParams& frame, RiveDrawParams* params, RiveDrawParams* params_end, rive::RenderPath* clip_path, rive::CommandServer* server)
+    {
+        if (frame.m_HasClipRect)
+        {
+            const rive::AABB& rect = frame.m_ClipRect;
+            clip_path->rewind();
+            clip_path->moveTo(rect.minX, rect.minY);
+            clip_path->lineTo(rect.maxX, rect.minY);
+            clip_path->lineTo(rect.maxX, rect.maxY);
+            clip_path->lineTo(rect.minX, rect.maxY);
+            clip_path->close();
+            frame.m_Renderer->save();
+            frame.m_Renderer->clipPath(clip_path);
+        }
+
+        for (; params != params_end; ++params)
+        {
+            params->m_Drawn = 0;
+
+            rive::ArtboardInstance* artboard = server->getArtboardInstance(params->m_Artboard);
+            if (artboard == nullptr)
+            {
+                continue;
+            }
+
+            rive::Mat2D renderer_transform;
+            if (params->m_CoordGame)
+            {
+                renderer_transform = dmRive::CalcTransformGame(artboard, frame.m_ViewTransform, params->m_WorldTransform, frame.m_DisplayFactor, frame.m_WindowHeight);
+            }
+            else
+            {
+                renderer_transform = dmRive::CalcTransformRive(artboard, params->m_Fit, params->m_Alignment, frame.m_Width, frame.m_Height, frame.m_DisplayFactor);
+            }
+
+            rive::Mat2D draw_transform = renderer_transform;
+            if (frame.m_FlipY)
+            {
+                draw_transform = rive::Mat2D::fromScaleAndTranslation(1.0f, -1.0f, 0.0f, (float)frame.m_Height) * renderer_transform;
+            }
+
+            if (dmRive::DrawArtboard(artboard, frame.m_Renderer, draw_transform))
+            {
+                // Input is given in window pixels
+                params->m_InverseRendererTransform = renderer_transform.invertOrIdentity() * rive::Mat2D::fromScale(frame.m_ResolutionScale, frame.m_ResolutionScale);
+                params->m_Bounds = artboard->bounds();
+                params->m_Clips = artboard->clip();
+                params->m_Drawn = 1;
+            }
+        }
+
+        if (frame.m_HasClipRect)
+        {
+            frame.m_Renderer->restore();
+        }
+    }
+
+    // Each artboard is fit into the whole render target. Only the shaders it needs matter, not what the frame looks like
+    static void DrawWarmUp(rive::CommandServer* server)
+    {
+        const WarmUp& warm_up = g_WarmUp;
+        for (uint32_t i = 0; i < warm_up.m_Artboards.Size(); ++i)
+        {
+            rive::ArtboardInstance* artboard = server->getArtboardInstance(warm_up.m_Artboards[i].m_Artboard);
+            if (artboard == nullptr)
+            {
+                continue;
+            }
+
+            rive::Mat2D transform = dmRive::CalcTransformRive(artboard, rive::Fit::contain, rive::Alignment::center, warm_up.m_Width, warm_up.m_Height, 1.0f);
+            dmRive::DrawArtboard(artboard, warm_up.m_Renderer, transform);
+        }
+    }
+
+    static void DrawWorld(RiveWorld* world, rive::CommandServer* server)
+    {
+        DrawArtboards(world->m_DrawFrame, world->m_DrawParams.Begin(), world->m_DrawParams.End(), world->m_ClipPath.get(), server);
+    }
+
     static rive::Mat2D GetViewTransform(dmRender::HRenderContext render_context)
     {
         const dmVMath::Matrix4& view_matrix = dmRender::GetViewMatrix(render_context);
@@ -174,13 +442,32 @@ namespace dmRive
         CompRiveContext* context = (CompRiveContext*)params.m_Context;
         RiveWorld* world         = new RiveWorld();
 
+        // The component storage is allocated when the first component is created
         world->m_Ctx = context;
-        world->m_Components.SetCapacity(context->m_MaxInstanceCount);
-        world->m_RenderObjects.SetCapacity(context->m_MaxInstanceCount);
-        world->m_RenderConstants.SetCapacity(context->m_MaxInstanceCount);
-        world->m_RenderConstants.SetSize(context->m_MaxInstanceCount);
+        world->m_RenderObjects.SetCapacity(1);
+        world->m_ComponentsHighWater = 0;
+        world->m_NextComponentId = 1;
+        world->m_UpdateToken = 0;
+        world->m_FrameSignature = 0;
+        world->m_FrameId = 0;
+        world->m_PoseChanged = true;
+        world->m_HasDirtyRegion = false;
+        world->m_DrawTarget = 0;
         world->m_BlitMaterial = 0;
+        world->m_AdvanceFence = 0;
         world->m_DidWork = false;
+
+        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        world->m_DrawKey = queue->createDrawKey();
+        world->m_DrawCallback = [world](rive::DrawKey, rive::CommandServer* server)
+        {
+            DrawWorld(world, server);
+        };
+        world->m_TargetDrawKey = queue->createDrawKey();
+        world->m_TargetDrawCallback = [world](rive::DrawKey, rive::CommandServer* server)
+        {
+            DrawArtboards(world->m_TargetDrawFrame, &world->m_TargetDrawParams, &world->m_TargetDrawParams + 1, 0, server);
+        };
         world->m_RiveRenderContext = context->m_RiveRenderContext;
 
         float bottom = 0.0f;
@@ -209,8 +496,6 @@ namespace dmRive
         dmGraphics::AddVertexStream(stream_declaration_vertex, "texcoord0", 2, dmGraphics::TYPE_FLOAT, false);
         world->m_VertexDeclaration = dmGraphics::NewVertexDeclaration(context->m_GraphicsContext, stream_declaration_vertex);
 
-        memset(world->m_RenderConstants.Begin(), 0, sizeof(dmGameSystem::HComponentRenderConstants)*world->m_RenderConstants.Capacity());
-
         *params.m_World = world;
 
         dmResource::RegisterResourceReloadedCallback(context->m_Factory, ResourceReloadedCallback, world);
@@ -222,6 +507,9 @@ namespace dmRive
     {
         RiveWorld* world = (RiveWorld*)params.m_World;
 
+        // The command server may still be reading the advance entries
+        ProcessAdvanceResults(world);
+
         dmGraphics::DeleteVertexBuffer(world->m_BlitToBackbufferVertexBuffer);
         dmGraphics::DeleteVertexDeclaration(world->m_VertexDeclaration);
 
@@ -266,9 +554,115 @@ namespace dmRive
         component->m_ReHash = 0;
     }
 
+    static inline void WakeComponent(RiveComponent* component)
+    {
+        component->m_Sleeping = 0;
+        component->m_Woken = 1;
+    }
+
+    // Reads back the results of the last batched advance
+    static void ProcessAdvanceResults(RiveWorld* world)
+    {
+        if (!world->m_AdvanceFence)
+        {
+            return;
+        }
+
+        dmRiveCommands::WaitFence(world->m_AdvanceFence);
+        world->m_AdvanceFence = 0;
+
+        bool sleep_settled = world->m_Ctx->m_SleepSettled;
+        const dmRiveCommands::AdvanceEntry* entries = world->m_AdvanceEntries.Begin();
+        uint32_t count = world->m_AdvanceEntries.Size();
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            RiveComponent* component = world->m_AdvanceComponents[i];
+            uint32_t result = entries[i].m_Result;
+            component->m_Deferred = (result & dmRiveCommands::ADVANCE_RESULT_DEFERRED) != 0;
+            component->m_Settled = (result & dmRiveCommands::ADVANCE_RESULT_SETTLED) != 0;
+            if (component->m_Deferred)
+            {
+                // The time is kept, and advanced with the next frame
+                component->m_AccumulatedDt += entries[i].m_DeltaTime;
+                DM_PROPERTY_ADD_U32(rmtp_RiveDeferred, 1);
+            }
+            // Anything that happened after the advance was queued may have changed the state
+            else if (sleep_settled && (result & dmRiveCommands::ADVANCE_RESULT_SETTLED) &&
+                     !component->m_Woken && component->m_AdvanceGeneration == g_WakeGeneration)
+            {
+                component->m_Sleeping = 1;
+            }
+        }
+
+        world->m_AdvanceEntries.SetSize(0);
+        world->m_AdvanceComponents.SetSize(0);
+    }
+
+    // Adds the render target pixels to the part of the last frame that must be redrawn
+    static void AddDirtyRegion(RiveWorld* world, const rive::AABB& bounds)
+    {
+        rive::AABB& region = world->m_DirtyRegion;
+        if (!world->m_HasDirtyRegion)
+        {
+            region = bounds;
+            world->m_HasDirtyRegion = true;
+            return;
+        }
+        region = rive::AABB(dmMath::Min(region.minX, bounds.minX), dmMath::Min(region.minY, bounds.minY),
+                            dmMath::Max(region.maxX, bounds.maxX), dmMath::Max(region.maxY, bounds.maxY));
+    }
+
+    // The per world storage grows in chunks of this many components
+    static const uint32_t CAPACITY_CHUNK_SIZE = 32;
+
+    // Grows the array to fit the size, and gives the memory back when most of it is unused after a peak.
+    // Must not be called while the array is in use, as the elements may be moved
+    template <typename T>
+    static void FitCapacity(dmArray<T>& array, uint32_t size)
+    {
+        uint32_t capacity = array.Capacity();
+        if (size > capacity || (capacity > CAPACITY_CHUNK_SIZE && size < capacity / 4))
+        {
+            uint32_t chunks = dmMath::Max(1U, (size + CAPACITY_CHUNK_SIZE - 1) / CAPACITY_CHUNK_SIZE);
+            array.SetCapacity(dmMath::Max(array.Size(), chunks * CAPACITY_CHUNK_SIZE));
+        }
+    }
+
+    // The components move, so this is only called where no RiveComponent* is held: see RiveWorld::m_Components
+    static bool GrowComponents(RiveWorld* world)
+    {
+        uint32_t capacity = world->m_Components.Capacity();
+        uint32_t max_count = world->m_Ctx->m_MaxInstanceCount;
+        if (max_count != 0 && capacity >= max_count)
+        {
+            return false;
+        }
+
+        uint32_t new_capacity = capacity + CAPACITY_CHUNK_SIZE;
+        if (max_count != 0)
+        {
+            new_capacity = dmMath::Min(new_capacity, max_count);
+        }
+
+        ProcessAdvanceResults(world);
+        world->m_Components.SetCapacity(new_capacity);
+        return true;
+    }
+
+    // Called at the start of the update, before any component pointer is taken for the frame, so that the components
+    // created during the frame fit without moving the others. Only a burst of more than a chunk grows the pool in the middle of a frame.
+    static void ReserveComponents(RiveWorld* world)
+    {
+        dmObjectPool<RiveComponent>& components = world->m_Components;
+        if (components.Capacity() != 0 && components.Size() + CAPACITY_CHUNK_SIZE / 2 > components.Capacity())
+        {
+            GrowComponents(world);
+        }
+    }
+
     static inline RiveComponent* GetComponentFromIndex(RiveWorld* world, int index)
     {
-        return world->m_Components.Get(index);
+        return &world->m_Components.Get(index);
     }
 
     void* CompRiveGetComponent(const dmGameObject::ComponentGetParams& params)
@@ -295,7 +689,15 @@ namespace dmRive
         rive::FileHandle file = data->m_File;
         rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
 
+        if (component->m_SharedInstance)
+        {
+            dmLogWarning("Cannot change the artboard of a Rive model using a shared instance");
+            return 0;
+        }
+
         rive::ArtboardHandle old_handle = component->m_Artboard;
+        // The old handle is given to the caller, and the new instance is not what the pool expects
+        component->m_InstancePoolKey = 0;
 
         if (artboard_name && artboard_name[0] != '\0')
         {
@@ -311,6 +713,13 @@ namespace dmRive
             component->m_Artboard = queue->instantiateDefaultArtboard(file);
         }
 
+        // The bounds are refreshed when the new artboard is drawn
+        component->m_HasBounds = 0;
+        component->m_Clips = 0;
+        component->m_Culled = 0;
+        component->m_ScreenSize = 0.0f;
+        WakeComponent(component);
+
         return old_handle;
     }
 
@@ -330,12 +739,31 @@ namespace dmRive
         queue->bindViewModelInstance(component->m_StateMachine, component->m_ViewModelInstance);
     }
 
+    static void OnStateMachineChanged(RiveComponent* component)
+    {
+        component->m_Enabled = component->m_StateMachine != 0;
+        WakeComponent(component);
+
+        if (component->m_StateMachine && component->m_Resource->m_DDF->m_AutoBind)
+        {
+            CompRiveSetViewModelInstance(component, 0);
+            BindViewModelInstance(component);
+        }
+    }
+
     rive::StateMachineHandle CompRiveSetStateMachine(RiveComponent* component, const char* state_machine_name)
     {
         rive::ArtboardHandle artboard = component->m_Artboard;
         rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
 
+        if (component->m_SharedInstance)
+        {
+            dmLogWarning("Cannot change the state machine of a Rive model using a shared instance");
+            return 0;
+        }
+
         rive::StateMachineHandle old_handle = component->m_StateMachine;
+        component->m_InstancePoolKey = 0;
 
         if (state_machine_name && state_machine_name[0] != '\0')
         {
@@ -351,14 +779,7 @@ namespace dmRive
             component->m_StateMachine = queue->instantiateDefaultStateMachine(artboard);
         }
 
-        component->m_Enabled = component->m_StateMachine != 0;
-
-        if (component->m_StateMachine && component->m_Resource->m_DDF->m_AutoBind)
-        {
-            CompRiveSetViewModelInstance(component, 0);
-            BindViewModelInstance(component);
-        }
-
+        OnStateMachineChanged(component);
         return old_handle;
     }
 
@@ -367,6 +788,12 @@ namespace dmRive
         rive::FileHandle              file = CompRiveGetFile(component);
         rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
 
+        if (component->m_SharedInstance)
+        {
+            dmLogWarning("Cannot change the view model instance of a Rive model using a shared instance");
+            return 0;
+        }
+
         rive::ViewModelInstanceHandle old_handle = component->m_ViewModelInstance;
 
         if (viewmodel_name && viewmodel_name[0] != '\0')
@@ -403,25 +830,68 @@ namespace dmRive
         }
 
         component->m_Enabled = component->m_ViewModelInstance != 0;
+        WakeComponent(component);
         return old_handle;
     }
 
+    static dmhash_t GetSharedInstanceKey(const RiveSceneData* scene_data, dmhash_t pool_key)
+    {
+        dmhash_t key[2] = { pool_key, (dmhash_t)(uintptr_t)scene_data };
+        return dmHashBuffer64(key, sizeof(key));
+    }
+
+    static RiveSharedInstance* AddSharedInstance(RiveWorld* world, RiveComponent* component, dmhash_t key)
+    {
+        RiveSharedInstance* shared = new RiveSharedInstance;
+        shared->m_Key               = key;
+        shared->m_Artboard          = component->m_Artboard;
+        shared->m_StateMachine      = component->m_StateMachine;
+        shared->m_ViewModelInstance = component->m_ViewModelInstance;
+        shared->m_RefCount          = 0;
+        shared->m_UpdateToken       = 0;
+
+        if (world->m_SharedInstances.Full())
+        {
+            uint32_t capacity = world->m_SharedInstances.Capacity() + 16;
+            world->m_SharedInstances.SetCapacity(dmMath::Max(7U, capacity / 2), capacity);
+        }
+        world->m_SharedInstances.Put(key, shared);
+        return shared;
+    }
+
+    // The last component to release the shared instance takes over its handles
+    static void ReleaseSharedInstance(RiveWorld* world, RiveComponent* component)
+    {
+        RiveSharedInstance* shared = component->m_SharedInstance;
+        component->m_SharedInstance = 0;
+        if (--shared->m_RefCount == 0)
+        {
+            world->m_SharedInstances.Erase(shared->m_Key);
+            delete shared;
+            return;
+        }
+        component->m_ViewModelInstance = 0;
+        component->m_StateMachine = 0;
+        component->m_Artboard = 0;
+    }
+
     dmGameObject::CreateResult CompRiveCreate(const dmGameObject::ComponentCreateParams& params)
     {
         RiveWorld* world = (RiveWorld*)params.m_World;
 
-        if (world->m_Components.Full())
+        // Normally reserved at the start of the update. Components are not created while the world is rendered,
+        // so the only pointers held here are the queued advances, which GrowComponents() flushes
+        if (world->m_Components.Full() && !GrowComponents(world))
         {
-            dmLogError("Rive instance could not be created since the buffer is full (%d).", world->m_Components.Capacity());
+            dmLogError("Rive instance could not be created since the buffer is full (%d). Increase the 'rive.max_instance_count' value in game.project", world->m_Components.Capacity());
             return dmGameObject::CREATE_RESULT_UNKNOWN_ERROR;
         }
 
-        RiveComponent* component = new RiveComponent;
-        memset(component, 0, sizeof(RiveComponent)); // yes, this works for dmArray and dmHashTable too
-
         uint32_t index = world->m_Components.Alloc();
-        world->m_Components.Set(index, component);
+        RiveComponent* component = &world->m_Components.Get(index);
+        memset(component, 0, sizeof(RiveComponent)); // yes, this works for dmArray and dmHashTable too
         component->m_Instance = params.m_Instance;
+        component->m_Id = world->m_NextComponentId++;
         component->m_Transform = dmTransform::Transform(Vector3(params.m_Position), params.m_Rotation, 1.0f);
         component->m_Resource = (RiveModelResource*)params.m_Resource;
 
@@ -433,14 +903,16 @@ namespace dmRive
         component->m_ComponentIndex = params.m_ComponentIndex;
         component->m_Enabled = 1;
         component->m_World = Matrix4::identity();
+        component->m_World2D = rive::Mat2D();
+        component->m_TransformDirty = 1;
         component->m_DoRender = 0;
         component->m_RenderConstants = 0;
         component->m_CurrentViewModelInstanceRuntime = INVALID_HANDLE;
-        component->m_DrawKey = queue->createDrawKey();
 
         dmRiveDDF::RiveModelDesc* ddf = component->m_Resource->m_DDF;
 
         component->m_CoordGame = ddf->m_CoordinateSystem == dmRiveDDF::RiveModelDesc::COORDINATE_SYSTEM_GAME;
+        component->m_UpdateRate = dmMath::Max(0.0f, ddf->m_UpdateRate);
         component->m_Fit = rive::Fit::layout;
         component->m_Alignment = rive::Alignment::center;
         if (!component->m_CoordGame)
@@ -449,8 +921,37 @@ namespace dmRive
             component->m_Alignment = DDFToRiveAlignment(ddf->m_ArtboardAlignment);
         }
 
-        CompRiveSetArtboard(component, ddf->m_Artboard);
-        CompRiveSetStateMachine(component, ddf->m_DefaultStateMachine);
+        // Reuse a released instance of the same artboard and state machine, if there is one
+        RiveSceneData* scene_data = (RiveSceneData*) component->m_Resource->m_Scene->m_Scene;
+        dmhash_t pool_key = GetInstancePoolKey(ddf->m_Artboard, ddf->m_DefaultStateMachine);
+        dmhash_t shared_key = ddf->m_SharedInstance ? GetSharedInstanceKey(scene_data, pool_key) : 0;
+        RiveSharedInstance** shared = shared_key ? world->m_SharedInstances.Get(shared_key) : 0;
+        RiveArtboardInstance instance;
+        if (shared)
+        {
+            component->m_Artboard = (*shared)->m_Artboard;
+            component->m_StateMachine = (*shared)->m_StateMachine;
+            component->m_ViewModelInstance = (*shared)->m_ViewModelInstance;
+            component->m_Enabled = component->m_StateMachine != 0;
+        }
+        else if (AcquirePooledInstance(scene_data, pool_key, &instance))
+        {
+            component->m_Artboard = instance.m_Artboard;
+            component->m_StateMachine = instance.m_StateMachine;
+            OnStateMachineChanged(component);
+        }
+        else
+        {
+            CompRiveSetArtboard(component, ddf->m_Artboard);
+            CompRiveSetStateMachine(component, ddf->m_DefaultStateMachine);
+        }
+        component->m_InstancePoolKey = pool_key;
+
+        if (shared_key)
+        {
+            component->m_SharedInstance = shared ? *shared : AddSharedInstance(world, component, shared_key);
+            component->m_SharedInstance->m_RefCount++;
+        }
 
         component->m_ReHash = 1;
 
@@ -464,13 +965,35 @@ namespace dmRive
 
         RiveComponent* component = GetComponentFromIndex(world, index);
 
+        // The advance results refer to the components, which are moved when one is freed
+        ProcessAdvanceResults(world);
+
+        if (component->m_WasDrawn)
+            AddDirtyRegion(world, component->m_DrawnBounds);
+
         if (component->m_RenderConstants)
             dmGameSystem::DestroyRenderConstants(component->m_RenderConstants);
 
+        if (component->m_SharedInstance)
+            ReleaseSharedInstance(world, component);
+
         if (component->m_ViewModelInstance)
             queue->deleteViewModelInstance(component->m_ViewModelInstance);
         component->m_ViewModelInstance = 0;
 
+        if (component->m_InstancePoolKey && component->m_Artboard && component->m_StateMachine)
+        {
+            RiveArtboardInstance instance;
+            instance.m_Artboard = component->m_Artboard;
+            instance.m_StateMachine = component->m_StateMachine;
+            RiveSceneData* scene_data = (RiveSceneData*) component->m_Resource->m_Scene->m_Scene;
+            if (ReleasePooledInstance(scene_data, component->m_InstancePoolKey, component->m_Resource->m_DDF->m_DefaultStateMachine, instance))
+            {
+                component->m_StateMachine = 0;
+                component->m_Artboard = 0;
+            }
+        }
+
         if (component->m_StateMachine)
             queue->deleteStateMachine(component->m_StateMachine);
         component->m_StateMachine = 0;
@@ -479,7 +1002,6 @@ namespace dmRive
             queue->deleteArtboard(component->m_Artboard);
         component->m_Artboard = 0;
 
-        delete component;
         world->m_Components.Free(index, true);
     }
 
@@ -492,18 +1014,298 @@ namespace dmRive
         if (component->m_Material) {
             dmResource::Release(ctx->m_Factory, (void*)component->m_Material);
         }
+        if (component->m_RenderTarget) {
+            dmResource::Release(ctx->m_Factory, (void*)component->m_RenderTarget);
+        }
         DestroyComponent(world, index);
         return dmGameObject::CREATE_RESULT_OK;
     }
 
+    // Only the draw parameters overlapping the region are kept, and they are clipped to it
+    static void ClipToRegion(RiveWorld* world, const rive::AABB& region)
+    {
+        dmArray<RiveDrawParams>& draw_params = world->m_DrawParams;
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < draw_params.Size(); ++i)
+        {
+            const RiveDrawParams& params = draw_params[i];
+            const rive::AABB& bounds = params.m_Component->m_DrawnBounds;
+            if (bounds.maxX < region.minX || bounds.maxY < region.minY || bounds.minX > region.maxX || bounds.minY > region.maxY)
+            {
+                continue;
+            }
+            draw_params[count++] = params;
+        }
+        draw_params.SetSize(count);
+
+        // Created once, and filled in by the command server
+        if (!world->m_ClipPath)
+        {
+            world->m_ClipPath = GetRiveFactory(world->m_RiveRenderContext)->makeEmptyRenderPath();
+            world->m_ClipPath->fillRule(rive::FillRule::nonZero);
+        }
+        world->m_DrawFrame.m_ClipRect = region;
+        world->m_DrawFrame.m_HasClipRect = true;
+    }
+
+    // Draws the world into the begun frame
+    static void DrawFrame(RiveWorld* world)
+    {
+        // This is the only fence per rendered world and frame: the advance commands
+        // from the update were queued before the draws, and the server executes them in order.
+        // It is also the hand-off point when the server runs on its own thread:
+        // the draw callback writes to the draw parameters and records into the renderer,
+        // and neither may be touched by the main thread until the fence has passed.
+        // Messages are delivered once per frame, in the extension update.
+        if (!world->m_DrawParams.Empty())
+        {
+            rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+            queue->draw(world->m_DrawKey, world->m_DrawCallback);
+        }
+
+        dmRiveCommands::WaitFence(dmRiveCommands::InsertFence());
+        DM_PROPERTY_ADD_U32(rmtp_RiveFencesPerFrame, 1);
+
+        // The advance was queued before the draw, so this doesn't wait
+        ProcessAdvanceResults(world);
+
+        for (uint32_t i = 0; i < world->m_DrawParams.Size(); ++i)
+        {
+            const RiveDrawParams& params = world->m_DrawParams[i];
+            if (params.m_Drawn)
+            {
+                RiveComponent* c = params.m_Component;
+                c->m_InverseRendererTransform = params.m_InverseRendererTransform;
+                if (c->m_Artboard == params.m_Artboard)
+                {
+                    c->m_Bounds = params.m_Bounds;
+                    c->m_HasBounds = 1;
+                    c->m_Clips = params.m_Clips;
+                }
+            }
+        }
+    }
+
+    static void RenderFrame(RiveWorld* world, const RenderBeginParams& begin_params)
+    {
+        world->m_DrawFrame.m_HasClipRect = false;
+        if (RenderBegin(world->m_RiveRenderContext, world->m_Ctx->m_Factory, begin_params))
+        {
+            rive::AABB region((float)begin_params.m_RegionX, (float)begin_params.m_RegionY,
+                              (float)(begin_params.m_RegionX + begin_params.m_RegionWidth), (float)(begin_params.m_RegionY + begin_params.m_RegionHeight));
+            ClipToRegion(world, region);
+            DM_PROPERTY_ADD_U32(rmtp_RivePartialFrames, 1);
+        }
+
+        DrawFrame(world);
+
+        RenderEnd(world->m_RiveRenderContext);
+        world->m_DrawFrame.m_HasClipRect = false;
+    }
+
+    // OpenGL draws in order, so the Rive pass is drawn on top of what the render script drew into the target before it.
+    // The other backends submit the Rive frame ahead of the rest of the frame, so the target is cleared instead.
+    static void RenderFrameToTarget(RiveWorld* world, dmGraphics::HRenderTarget render_target)
+    {
+        world->m_DrawFrame.m_HasClipRect = false;
+        bool preserve = dmGraphics::GetInstalledAdapterFamily() == dmGraphics::ADAPTER_FAMILY_OPENGL;
+        uint32_t width, height;
+        if (!RenderBeginTarget(world->m_RiveRenderContext, world->m_Ctx->m_Factory, render_target, g_RenderBeginParams.m_ClearColor, preserve, &width, &height))
+        {
+            dmLogOnceError("Failed to draw Rive into the render target set with rive.set_render_target()");
+            ProcessAdvanceResults(world);
+            return;
+        }
+
+        DrawFrame(world);
+
+        RenderEnd(world->m_RiveRenderContext);
+        DM_PROPERTY_ADD_U32(rmtp_RiveRenderTargets, 1);
+    }
+
+    static inline bool IsSameFrame(const RiveDrawFrameParams& a, const RiveDrawFrameParams& b)
+    {
+        return a.m_Width == b.m_Width && a.m_Height == b.m_Height && a.m_WindowHeight == b.m_WindowHeight &&
+               a.m_DisplayFactor == b.m_DisplayFactor && memcmp(&a.m_ViewTransform, &b.m_ViewTransform, sizeof(rive::Mat2D)) == 0;
+    }
+
+    // Collects the render target pixels that changed since the last frame of this world: the components that were added,
+    // removed, hidden, moved or advanced to a new pose, before and after. Components without known on screen bounds cover the whole target,
+    // and so do the ones whose artboard doesn't clip, since they may draw outside of their bounds.
+    // Also remembers what each component covers in this frame.
+    static void UpdateDirtyRegion(RiveWorld* world)
+    {
+        const RiveDrawFrameParams& frame = world->m_DrawFrame;
+        const rive::AABB target(0.0f, 0.0f, (float)frame.m_Width, (float)frame.m_Height);
+
+        for (uint32_t i = 0; i < world->m_DrawParams.Size(); ++i)
+        {
+            const RiveDrawParams& params = world->m_DrawParams[i];
+            RiveComponent* c = params.m_Component;
+            rive::AABB bounds = params.m_HasScreenBounds && c->m_Clips ? params.m_ScreenBounds : target;
+            if (!c->m_WasDrawn)
+            {
+                AddDirtyRegion(world, bounds);
+            }
+            else if (c->m_PoseChanged || memcmp(&bounds, &c->m_DrawnBounds, sizeof(rive::AABB)) != 0)
+            {
+                AddDirtyRegion(world, c->m_DrawnBounds);
+                AddDirtyRegion(world, bounds);
+            }
+            c->m_DrawnBounds = bounds;
+            c->m_PoseChanged = 0;
+        }
+
+        dmArray<RiveComponent>& components = world->m_Components.GetRawObjects();
+        for (uint32_t i = 0; i < components.Size(); ++i)
+        {
+            RiveComponent& c = components[i];
+            if (c.m_WasDrawn && !c.m_InFrame)
+            {
+                AddDirtyRegion(world, c.m_DrawnBounds);
+            }
+            c.m_WasDrawn = c.m_InFrame;
+            c.m_InFrame = 0;
+        }
+    }
+
+    // Antialiasing may reach a bit outside of the bounds
+    static const float DIRTY_REGION_PADDING = 2.0f;
+
+    // Sets up a partial redraw of the last frame, if it is intact and the changed part is small enough to be worth it.
+    // Returns false if nothing changed, and the last frame can be shown as is.
+    static bool GetRedrawRegion(RiveWorld* world, uint64_t signature, RenderBeginParams& begin_params)
+    {
+        const RiveDrawFrameParams& frame = world->m_DrawFrame;
+        bool is_intact = world->m_Ctx->m_PartialRedraw && !g_ForceFullRedraw && begin_params.m_DoFinalBlit &&
+                         world->m_FrameId != 0 && world->m_FrameId == GetFrameId(world->m_RiveRenderContext) &&
+                         IsSameFrame(frame, world->m_DrawnFrame);
+        if (!is_intact)
+        {
+            return true;
+        }
+
+        if (!world->m_HasDirtyRegion)
+        {
+            // A new draw order or artboard doesn't show up in the bounds
+            return world->m_FrameSignature != signature;
+        }
+
+        const rive::AABB& region = world->m_DirtyRegion;
+        float min_x = dmMath::Max(floorf(region.minX - DIRTY_REGION_PADDING), 0.0f);
+        float min_y = dmMath::Max(floorf(region.minY - DIRTY_REGION_PADDING), 0.0f);
+        float max_x = dmMath::Min(ceilf(region.maxX + DIRTY_REGION_PADDING), (float)frame.m_Width);
+        float max_y = dmMath::Min(ceilf(region.maxY + DIRTY_REGION_PADDING), (float)frame.m_Height);
+        if (max_x <= min_x || max_y <= min_y)
+        {
+            return false;
+        }
+
+        // Clearing and clipping costs more than it saves when most of the target changed
+        float area = (max_x - min_x) * (max_y - min_y);
+        if (area < 0.5f * (float)frame.m_Width * (float)frame.m_Height)
+        {
+            begin_params.m_RegionX      = (uint32_t)min_x;
+            begin_params.m_RegionY      = (uint32_t)min_y;
+            begin_params.m_RegionWidth  = (uint32_t)(max_x - min_x);
+            begin_params.m_RegionHeight = (uint32_t)(max_y - min_y);
+        }
+        return true;
+    }
+
+    // Everything a frame is drawn from, except for the artboard poses
+    static uint64_t GetFrameSignature(RiveWorld* world)
+    {
+        HashState64 state;
+        dmHashInit64(&state, false);
+
+        const RiveDrawFrameParams& frame = world->m_DrawFrame;
+        dmHashUpdateBuffer64(&state, &frame.m_ViewTransform, sizeof(frame.m_ViewTransform));
+        dmHashUpdateBuffer64(&state, &frame.m_Width, sizeof(frame.m_Width));
+        dmHashUpdateBuffer64(&state, &frame.m_Height, sizeof(frame.m_Height));
+        dmHashUpdateBuffer64(&state, &frame.m_WindowHeight, sizeof(frame.m_WindowHeight));
+        dmHashUpdateBuffer64(&state, &frame.m_DisplayFactor, sizeof(frame.m_DisplayFactor));
+
+        for (uint32_t i = 0; i < world->m_DrawParams.Size(); ++i)
+        {
+            const RiveDrawParams& params = world->m_DrawParams[i];
+            uint8_t coord_game = params.m_CoordGame;
+            // Not the address, since another component may be moved into the place of a freed one
+            dmHashUpdateBuffer64(&state, &params.m_Component->m_Id, sizeof(params.m_Component->m_Id));
+            dmHashUpdateBuffer64(&state, &params.m_Artboard, sizeof(params.m_Artboard));
+            dmHashUpdateBuffer64(&state, &params.m_Fit, sizeof(params.m_Fit));
+            dmHashUpdateBuffer64(&state, &params.m_Alignment, sizeof(params.m_Alignment));
+            dmHashUpdateBuffer64(&state, &coord_game, sizeof(coord_game));
+            if (coord_game)
+            {
+                dmHashUpdateBuffer64(&state, &params.m_WorldTransform, sizeof(params.m_WorldTransform));
+            }
+        }
+        return dmHashFinal64(&state);
+    }
+
+    // The last frame can be blitted again if it was the last one drawn into the Rive render target,
+    // and it would be drawn from the same components, artboard poses and transforms
+    static bool CanReuseFrame(RiveWorld* world, uint64_t signature)
+    {
+        return world->m_Ctx->m_FrameCache &&
+               !g_ForceFullRedraw &&
+               g_RenderBeginParams.m_DoFinalBlit &&
+               !world->m_PoseChanged &&
+               world->m_FrameId != 0 &&
+               world->m_FrameId == GetFrameId(world->m_RiveRenderContext) &&
+               world->m_FrameSignature == signature;
+    }
+
     static void RenderBatchEnd(RiveWorld* world, dmRender::HRenderContext render_context)
     {
         if (world->m_RiveRenderContext)
         {
-            // Current-frame draw callbacks are executed by the command server
-            // after it drains commands, so this fence must stay on the render path.
-            dmRiveCommands::ProcessMessages();
-            RenderEnd(world->m_RiveRenderContext);
+            UpdateDirtyRegion(world);
+
+            if (world->m_DrawTarget)
+            {
+                RenderFrameToTarget(world, world->m_DrawTarget);
+
+                // The Rive render target no longer holds what the world looks like
+                world->m_FrameId = 0;
+                world->m_HasDirtyRegion = false;
+                return;
+            }
+
+            uint64_t signature = GetFrameSignature(world);
+            if (CanReuseFrame(world, signature))
+            {
+                ProcessAdvanceResults(world);
+                DM_PROPERTY_ADD_U32(rmtp_RiveFrameCacheHits, 1);
+            }
+            else
+            {
+                RenderBeginParams begin_params = g_RenderBeginParams;
+                if (GetRedrawRegion(world, signature, begin_params))
+                {
+                    uint64_t start = dmTime::GetMonotonicTime();
+                    RenderFrame(world, begin_params);
+                    uint64_t render_time = dmTime::GetMonotonicTime() - start;
+                    g_FrameCpuTime += render_time;
+                    ++g_FrameCpuCount;
+                    world->m_FrameId = GetFrameId(world->m_RiveRenderContext);
+                    if (world->m_Ctx->m_FrameCache)
+                    {
+                        DM_PROPERTY_ADD_U32(rmtp_RiveFrameCacheMisses, 1);
+                    }
+                }
+                else
+                {
+                    // Nothing visible changed
+                    ProcessAdvanceResults(world);
+                    DM_PROPERTY_ADD_U32(rmtp_RiveFrameCacheHits, 1);
+                }
+                world->m_FrameSignature = signature;
+                world->m_PoseChanged = false;
+            }
+            world->m_DrawnFrame = world->m_DrawFrame;
+            world->m_HasDirtyRegion = false;
 
             if (g_RenderBeginParams.m_DoFinalBlit)
             {
@@ -523,25 +1325,86 @@ namespace dmRive
         }
     }
 
-    static void RenderBatch(RiveWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
+    // The artboard bounds in render target pixels, for the Game coordinate system
+    static rive::AABB GetScreenBounds(const rive::AABB& bounds, const RiveDrawFrameParams& frame, const rive::Mat2D& world_transform)
     {
-        RiveComponent*              first    = (RiveComponent*) buf[*begin].m_UserData;
-        dmRive::RiveSceneResource* scene_res = first->m_Resource->m_Scene;
-        dmRive::RiveSceneData* data          = (dmRive::RiveSceneData*) scene_res->m_Scene;
+        rive::Mat2D renderer_transform = dmRive::CalcTransformGame(bounds, frame.m_ViewTransform, world_transform, frame.m_DisplayFactor, frame.m_WindowHeight);
+        return renderer_transform.mapBoundingBox(bounds);
+    }
 
-        RenderBegin(world->m_RiveRenderContext, world->m_Ctx->m_Factory, g_RenderBeginParams);
+    static bool IsOutsideTarget(const rive::AABB& screen_bounds, const RiveDrawFrameParams& frame)
+    {
+        return screen_bounds.maxX < 0.0f || screen_bounds.maxY < 0.0f ||
+               screen_bounds.minX > (float)frame.m_Width || screen_bounds.minY > (float)frame.m_Height;
+    }
 
-        uint32_t width, height;
-        GetDimensions(world->m_RiveRenderContext, &width, &height);
+    static bool GetRenderTargetSize(dmGraphics::HContext graphics_context, dmGraphics::HRenderTarget render_target, uint32_t* width, uint32_t* height)
+    {
+        dmGraphics::HTexture texture = dmGraphics::GetRenderTargetTexture(graphics_context, render_target, dmGraphics::BUFFER_TYPE_COLOR0_BIT);
+        if (texture == 0)
+        {
+            return false;
+        }
+        *width = dmGraphics::GetTextureWidth(graphics_context, texture);
+        *height = dmGraphics::GetTextureHeight(graphics_context, texture);
+        return *width != 0 && *height != 0;
+    }
 
+    static void RenderBatch(RiveWorld* world, dmRender::HRenderContext render_context, dmRender::RenderListEntry *buf, uint32_t* begin, uint32_t* end)
+    {
+        RiveDrawFrameParams& frame = world->m_DrawFrame;
+        uint32_t window_width  = dmGraphics::GetWindowWidth(world->m_Ctx->m_GraphicsContext);
         uint32_t window_height = dmGraphics::GetWindowHeight(world->m_Ctx->m_GraphicsContext);
+        float resolution_scale = 1.0f;
+        bool flip_y = false;
+
+        // A render target set by the render script is drawn into directly, and the view is scaled to it like to the window.
+        // The Rive render target isn't used, and isn't allocated if it hasn't been already.
+        world->m_DrawTarget = g_RenderTarget;
+        if (world->m_DrawTarget && !dmGraphics::IsAssetHandleValid(world->m_Ctx->m_GraphicsContext, world->m_DrawTarget))
+        {
+            dmLogWarning("The render target set with rive.set_render_target() has been deleted. Rive is drawn to the window again.");
+            g_RenderTarget = 0;
+            world->m_DrawTarget = 0;
+        }
+        if (world->m_DrawTarget && GetRenderTargetSize(world->m_Ctx->m_GraphicsContext, world->m_DrawTarget, &frame.m_Width, &frame.m_Height))
+        {
+            resolution_scale = (float)frame.m_Height / (float)dmMath::Max(1u, window_height);
+            flip_y = dmGraphics::GetInstalledAdapterFamily() != dmGraphics::ADAPTER_FAMILY_OPENGL;
+        }
+        else
+        {
+            world->m_DrawTarget = 0;
 
-        rive::Mat2D view_transform = GetViewTransform(render_context);
-        rive::Renderer* renderer = GetRiveRenderer(world->m_RiveRenderContext);
+            // Without the blit, the Rive frame is drawn straight to the window
+            resolution_scale = g_RenderBeginParams.m_DoFinalBlit ? g_Resolution.m_Scale : 1.0f;
+            g_RenderBeginParams.m_Width  = 0;
+            g_RenderBeginParams.m_Height = 0;
+            if (resolution_scale != 1.0f)
+            {
+                g_RenderBeginParams.m_Width  = dmMath::Max(1u, (uint32_t)(window_width * resolution_scale + 0.5f));
+                g_RenderBeginParams.m_Height = dmMath::Max(1u, (uint32_t)(window_height * resolution_scale + 0.5f));
+            }
 
-        float display_factor  = g_DisplayFactor;
+            DM_PROPERTY_SET_F32(rmtp_RiveResolutionScale, resolution_scale);
 
-        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+            RenderPrepare(world->m_RiveRenderContext, world->m_Ctx->m_Factory, g_RenderBeginParams);
+            GetDimensions(world->m_RiveRenderContext, &frame.m_Width, &frame.m_Height);
+        }
+
+        frame.m_WindowHeight    = resolution_scale != 1.0f ? frame.m_Height : window_height;
+        frame.m_ViewTransform   = GetViewTransform(render_context);
+        frame.m_Renderer        = GetRiveRenderer(world->m_RiveRenderContext);
+        frame.m_DisplayFactor   = g_DisplayFactor * resolution_scale;
+        frame.m_ResolutionScale = resolution_scale;
+        frame.m_FlipY           = flip_y;
+
+        dmArray<RiveDrawParams>& draw_params = world->m_DrawParams;
+        uint32_t batch_size = (uint32_t)(end - begin);
+        if (draw_params.Remaining() < batch_size)
+        {
+            draw_params.OffsetCapacity(batch_size - draw_params.Remaining());
+        }
 
         for (uint32_t *i=begin;i!=end;i++)
         {
@@ -550,53 +1413,47 @@ namespace dmRive
             if (!c->m_Enabled || !c->m_AddedToUpdate)
                 continue;
 
-            const rive::ArtboardHandle  artboardHandle  = c->m_Artboard;
-            rive::Fit                   fit             = c->m_Fit;
-            rive::Alignment             alignment       = c->m_Alignment;
-            bool                        coord_game      = c->m_CoordGame;
-
             rive::Mat2D world_transform;
-            if (coord_game)
+            if (c->m_CoordGame)
             {
-                Mat4ToMat2D(c->m_World, world_transform);
+                world_transform = c->m_World2D;
             }
 
-            auto drawLoop = [artboardHandle,
-                             renderer,
-                             fit,
-                             alignment,
-                             coord_game,
-                             world_transform,
-                             view_transform,
-                             width,
-                             height,
-                             window_height,
-                             display_factor,
-                             c](rive::DrawKey, rive::CommandServer* server)
+            // Components using the Rive coordinate system are fitted to the target, and always visible
+            c->m_Culled = 0;
+            rive::AABB screen_bounds;
+            bool has_screen_bounds = false;
+            if (!c->m_CoordGame)
             {
-                rive::ArtboardInstance* artboard = server->getArtboardInstance(artboardHandle);
-                if (artboard == nullptr)
-                {
-                    return;
-                }
-
-                rive::Mat2D renderer_transform;
-                if (coord_game)
-                {
-                    renderer_transform = dmRive::CalcTransformGame(artboard, view_transform, world_transform, display_factor, window_height);
-                }
-                else
-                {
-                    renderer_transform = dmRive::CalcTransformRive(artboard, fit, alignment, width, height, display_factor);
-                }
+                c->m_ScreenSize = (float)dmMath::Max(frame.m_Width, frame.m_Height) / resolution_scale;
+            }
+            else if (c->m_HasBounds)
+            {
+                screen_bounds = GetScreenBounds(c->m_Bounds, frame, world_transform);
+                has_screen_bounds = true;
+                c->m_ScreenSize = dmMath::Max(screen_bounds.width(), screen_bounds.height()) / resolution_scale;
+                c->m_Culled = world->m_Ctx->m_Culling && IsOutsideTarget(screen_bounds, frame);
+            }
 
-                if (dmRive::DrawArtboard(artboard, renderer, renderer_transform))
-                {
-                    c->m_InverseRendererTransform = renderer_transform.invertOrIdentity();
-                }
-            };
+            if (c->m_Culled)
+            {
+                DM_PROPERTY_ADD_U32(rmtp_RiveCulled, 1);
+                continue;
+            }
 
-            queue->draw(c->m_DrawKey, drawLoop);
+            RiveDrawParams params;
+            params.m_Component = c;
+            params.m_Artboard  = c->m_Artboard;
+            params.m_Fit       = c->m_Fit;
+            params.m_Alignment = c->m_Alignment;
+            params.m_CoordGame = c->m_CoordGame;
+            params.m_Drawn     = 0;
+            params.m_Clips     = 0;
+            params.m_WorldTransform = world_transform;
+            params.m_ScreenBounds = screen_bounds;
+            params.m_HasScreenBounds = has_screen_bounds;
+            draw_params.Push(params);
+            c->m_InFrame = 1;
         }
     }
 
@@ -604,18 +1461,25 @@ namespace dmRive
     {
         DM_PROFILE("UpdateTransforms");
 
-        dmArray<RiveComponent*>& components = world->m_Components.GetRawObjects();
+        dmArray<RiveComponent>& components = world->m_Components.GetRawObjects();
         uint32_t n = components.Size();
         for (uint32_t i = 0; i < n; ++i)
         {
-            RiveComponent* c = components[i];
+            RiveComponent* c = &components[i];
 
             if (!c->m_Enabled || !c->m_AddedToUpdate)
                 continue;
 
+            // Most models are stationary, so only recalculate when the game object has moved
             const Matrix4& go_world = dmGameObject::GetWorldMatrix(c->m_Instance);
+            if (!c->m_TransformDirty && memcmp(&go_world, &c->m_GameObjectWorld, sizeof(Matrix4)) == 0)
+                continue;
+
             const Matrix4 local = dmTransform::ToMatrix4(c->m_Transform);
+            c->m_GameObjectWorld = go_world;
             c->m_World = go_world * local;
+            Mat4ToMat2D(c->m_World, c->m_World2D);
+            c->m_TransformDirty = 0;
         }
     }
 
@@ -623,7 +1487,7 @@ namespace dmRive
     {
         RiveWorld* world = (RiveWorld*)params.m_World;
         uint32_t index = (uint32_t)*params.m_UserData;
-        RiveComponent* component = world->m_Components.Get(index);
+        RiveComponent* component = GetComponentFromIndex(world, index);
         component->m_AddedToUpdate = true;
         return dmGameObject::CREATE_RESULT_OK;
     }
@@ -652,6 +1516,30 @@ namespace dmRive
         component->m_AnimationPlayback     = dmGameObject::PLAYBACK_NONE;
     }
 
+    // The components are advanced in this order when there is an advance budget: recently interacted with,
+    // deferred last frame (so that everything is eventually advanced), visible, and then by on screen size
+    static bool AdvancePriorityGreater(const RiveComponent* a, const RiveComponent* b)
+    {
+        if (a->m_Woken != b->m_Woken)
+            return a->m_Woken;
+        if (a->m_Deferred != b->m_Deferred)
+            return a->m_Deferred;
+        if (a->m_Culled != b->m_Culled)
+            return !a->m_Culled;
+        return a->m_ScreenSize > b->m_ScreenSize;
+    }
+
+    static inline float GetUpdateRate(const CompRiveContext* ctx, const RiveComponent* component)
+    {
+        float update_rate = component->m_UpdateRate;
+        bool is_small = component->m_ScreenSize > 0.0f && component->m_ScreenSize < ctx->m_LodScreenSize;
+        if (is_small && ctx->m_LodUpdateRate > 0.0f && (update_rate == 0.0f || update_rate > ctx->m_LodUpdateRate))
+        {
+            update_rate = ctx->m_LodUpdateRate;
+        }
+        return update_rate;
+    }
+
     dmGameObject::UpdateResult CompRiveUpdate(const dmGameObject::ComponentsUpdateParams& params, dmGameObject::ComponentsUpdateResult& update_result)
     {
         DM_PROFILE("RiveModel");
@@ -659,15 +1547,27 @@ namespace dmRive
 
         float dt = params.m_UpdateContext->m_DT;
 
-        dmArray<RiveComponent*>& components = world->m_Components.GetRawObjects();
+        // Normally signaled already, by the render fence of the previous frame
+        ProcessAdvanceResults(world);
+        ReserveComponents(world);
+        ApplyWakeRequests(world);
+
+        dmArray<RiveComponent>& components = world->m_Components.GetRawObjects();
         const uint32_t count = components.Size();
+        world->m_ComponentsHighWater = dmMath::Max(world->m_ComponentsHighWater, count);
         DM_PROPERTY_ADD_U32(rmtp_RiveComponents, count);
+        DM_PROPERTY_ADD_U32(rmtp_RiveComponentsPeak, world->m_ComponentsHighWater);
 
-        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        world->m_UpdateToken++;
+
+        dmArray<dmRiveCommands::AdvanceEntry>& advance_entries = world->m_AdvanceEntries;
+        dmArray<RiveComponent*>& advance_components = world->m_AdvanceComponents;
+        FitCapacity(advance_entries, count);
+        FitCapacity(advance_components, count);
 
         for (uint32_t i = 0; i < count; ++i)
         {
-            RiveComponent& component = *components[i];
+            RiveComponent& component = components[i];
             component.m_DoRender = 0;
 
             if (!component.m_Enabled || !component.m_AddedToUpdate)
@@ -675,17 +1575,91 @@ namespace dmRive
                 continue;
             }
 
-            queue->advanceStateMachine(component.m_StateMachine, dt * component.m_AnimationPlaybackRate);
+            // Culled components are still submitted for rendering, as that is where the visibility is updated
+            component.m_DoRender = 1;
 
             if (component.m_ReHash || (component.m_RenderConstants && dmGameSystem::AreRenderConstantsUpdated(component.m_RenderConstants)))
             {
                 ReHash(&component);
             }
 
-            component.m_DoRender = 1;
+            if (component.m_Culled && world->m_Ctx->m_CullingPauseAdvance)
+            {
+                continue;
+            }
+
+            if (component.m_Sleeping)
+            {
+                if (component.m_AdvanceGeneration == g_WakeGeneration)
+                {
+                    DM_PROPERTY_ADD_U32(rmtp_RiveSleeping, 1);
+                    continue;
+                }
+                component.m_Sleeping = 0;
+            }
+
+            component.m_AccumulatedDt += dt * component.m_AnimationPlaybackRate;
+
+            // Input and data changes are advanced right away, so they aren't delayed by a low update rate
+            float update_rate = GetUpdateRate(world->m_Ctx, &component);
+            if (!component.m_Woken && !component.m_Deferred && update_rate > 0.0f && component.m_AccumulatedDt < 1.0f / update_rate)
+            {
+                continue;
+            }
+
+            // A shared instance is advanced by the first of its components
+            RiveSharedInstance* shared = component.m_SharedInstance;
+            if (shared)
+            {
+                if (shared->m_UpdateToken == world->m_UpdateToken)
+                {
+                    component.m_AccumulatedDt = 0.0f;
+                    continue;
+                }
+                shared->m_UpdateToken = world->m_UpdateToken;
+            }
+
+            advance_components.Push(&component);
+        }
+
+        uint32_t advance_budget = world->m_Ctx->m_AdvanceBudget;
+        if (advance_budget != 0)
+        {
+            std::sort(advance_components.Begin(), advance_components.End(), AdvancePriorityGreater);
+        }
+
+        uint32_t advance_count = advance_components.Size();
+        for (uint32_t i = 0; i < advance_count; ++i)
+        {
+            RiveComponent& component = *advance_components[i];
+
+            // Advancing a settled state machine doesn't change its artboard, unless something else happened to it
+            if (!component.m_RenderTarget && (!component.m_Settled || component.m_Woken || component.m_AdvanceGeneration != g_WakeGeneration))
+            {
+                world->m_PoseChanged = true;
+                component.m_PoseChanged = 1;
+            }
+
+            component.m_Woken = 0;
+            component.m_AdvanceGeneration = g_WakeGeneration;
+            component.m_RenderTargetDirty = 1;
+
+            dmRiveCommands::AdvanceEntry entry;
+            entry.m_StateMachine = component.m_StateMachine;
+            entry.m_DeltaTime    = component.m_AccumulatedDt;
+            entry.m_Result       = 0;
+            advance_entries.Push(entry);
+            component.m_AccumulatedDt = 0.0f;
+        }
+
+        if (!advance_entries.Empty())
+        {
+            world->m_AdvanceFence = dmRiveCommands::AdvanceStateMachines(advance_entries.Begin(), advance_entries.Size(), advance_budget);
         }
 
-        dmRiveCommands::ProcessMessages(); // Update the command server
+        // Let the command thread start advancing while the rest of the frame is updated.
+        // The render path fences the server before the Rive frame is flushed.
+        dmRiveCommands::Kick();
 
         update_result.m_TransformsUpdated = false;
 
@@ -700,9 +1674,9 @@ namespace dmRive
         {
             case dmRender::RENDER_LIST_OPERATION_BEGIN:
             {
-                // Drain any queued non-draw work before the render batch starts.
-                dmRiveCommands::ProcessMessages();
                 world->m_RenderObjects.SetSize(0);
+                world->m_DrawParams.SetSize(0);
+                FitCapacity(world->m_DrawParams, world->m_Components.Size());
                 world->m_DidWork = false;
                 break;
             }
@@ -726,6 +1700,135 @@ namespace dmRive
         }
     }
 
+    // Components with a render target are drawn into it, fitted to its size, instead of into the Rive render target.
+    // Each render target is a frame (and a fence) of its own, so it is only redrawn after its state machine was advanced.
+    // The frames of all the render targets are submitted to the GPU at once.
+    // The update rate of the component is therefore also the rate the render target is updated at.
+    static void RenderTargets(RiveWorld* world)
+    {
+        DM_PROFILE("RenderTargets");
+
+        dmArray<RiveComponent>& components = world->m_Components.GetRawObjects();
+        const uint32_t count = components.Size();
+        bool did_draw = false;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            RiveComponent& c = components[i];
+            if (!c.m_RenderTarget || !c.m_RenderTargetDirty || !c.m_DoRender || !c.m_Enabled)
+            {
+                continue;
+            }
+
+            RiveDrawFrameParams& frame = world->m_TargetDrawFrame;
+            if (!RenderBeginTarget(world->m_RiveRenderContext, world->m_Ctx->m_Factory, c.m_RenderTarget->m_RenderTarget, 0, false, &frame.m_Width, &frame.m_Height))
+            {
+                continue;
+            }
+
+            frame.m_Renderer      = GetRiveRenderer(world->m_RiveRenderContext);
+            frame.m_HasClipRect   = false;
+            frame.m_ViewTransform = rive::Mat2D();
+            frame.m_WindowHeight  = frame.m_Height;
+            frame.m_DisplayFactor = 1.0f;
+            frame.m_ResolutionScale = 1.0f;
+            frame.m_FlipY         = dmGraphics::GetInstalledAdapterFamily() != dmGraphics::ADAPTER_FAMILY_OPENGL;
+
+            RiveDrawParams& params = world->m_TargetDrawParams;
+            params.m_Component      = &c;
+            params.m_Artboard       = c.m_Artboard;
+            params.m_Fit            = c.m_Fit;
+            params.m_Alignment      = c.m_Alignment;
+            params.m_CoordGame      = 0;
+            params.m_Drawn          = 0;
+            params.m_Clips          = 0;
+            params.m_WorldTransform = rive::Mat2D();
+
+            rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+            queue->draw(world->m_TargetDrawKey, world->m_TargetDrawCallback);
+            dmRiveCommands::WaitFence(dmRiveCommands::InsertFence());
+            DM_PROPERTY_ADD_U32(rmtp_RiveFencesPerFrame, 1);
+            DM_PROPERTY_ADD_U32(rmtp_RiveRenderTargets, 1);
+
+            // Submitted together after the loop
+            RenderEnd(world->m_RiveRenderContext, false);
+
+            if (params.m_Drawn)
+            {
+                c.m_InverseRendererTransform = params.m_InverseRendererTransform;
+                c.m_Bounds = params.m_Bounds;
+                c.m_HasBounds = 1;
+            }
+            c.m_ScreenSize = (float)dmMath::Max(frame.m_Width, frame.m_Height);
+            c.m_Culled = 0;
+            c.m_RenderTargetDirty = 0;
+            did_draw = true;
+        }
+
+        // The advance was queued before the draws, so this doesn't wait
+        if (did_draw)
+        {
+            RenderSubmit(world->m_RiveRenderContext);
+            ProcessAdvanceResults(world);
+        }
+    }
+
+    // Draws the queued warm-up artboards in a frame of their own, in the render pass of the first world rendered.
+    // The frame is drawn into the Rive render target, and the next frame of each world is redrawn since the frame id changes.
+    // Without the render to texture, it would be drawn into the window, so the warm-up is skipped.
+    static void RenderWarmUp(CompRiveContext* ctx)
+    {
+        WarmUp& warm_up = g_WarmUp;
+        if (warm_up.m_Requests.Empty())
+        {
+            return;
+        }
+
+        DM_PROFILE("RiveWarmUp");
+
+        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        bool warmed_up = g_RenderBeginParams.m_DoFinalBlit;
+        if (warmed_up)
+        {
+            RenderBeginParams begin_params = g_RenderBeginParams;
+            begin_params.m_RegionWidth = 0;
+            begin_params.m_RegionHeight = 0;
+            RenderBegin(ctx->m_RiveRenderContext, ctx->m_Factory, begin_params);
+
+            warm_up.m_Renderer = GetRiveRenderer(ctx->m_RiveRenderContext);
+            GetDimensions(ctx->m_RiveRenderContext, &warm_up.m_Width, &warm_up.m_Height);
+            queue->draw(warm_up.m_DrawKey, warm_up.m_DrawCallback);
+            dmRiveCommands::WaitFence(dmRiveCommands::InsertFence());
+            DM_PROPERTY_ADD_U32(rmtp_RiveFencesPerFrame, 1);
+
+            RenderEnd(ctx->m_RiveRenderContext);
+        }
+        else
+        {
+            dmLogWarning("The Rive warm-up needs 'rive.render_to_texture' to be enabled. The shaders are compiled when first drawn instead.");
+        }
+
+        for (uint32_t i = 0; i < warm_up.m_Artboards.Size(); ++i)
+        {
+            queue->deleteStateMachine(warm_up.m_Artboards[i].m_StateMachine);
+            queue->deleteArtboard(warm_up.m_Artboards[i].m_Artboard);
+        }
+        warm_up.m_Artboards.SetSize(0);
+
+        // The callbacks are called from the extension update, with the other script callbacks
+        if (warm_up.m_Done.Remaining() < warm_up.m_Requests.Size())
+        {
+            warm_up.m_Done.OffsetCapacity(warm_up.m_Requests.Size() - warm_up.m_Done.Remaining());
+        }
+        for (uint32_t i = 0; i < warm_up.m_Requests.Size(); ++i)
+        {
+            WarmUpRequest request = warm_up.m_Requests[i];
+            request.m_WarmedUp = warmed_up;
+            warm_up.m_Done.Push(request);
+        }
+        warm_up.m_Requests.SetSize(0);
+    }
+
     dmGameObject::UpdateResult CompRiveRender(const dmGameObject::ComponentsRenderParams& params)
     {
         DM_PROFILE("RiveModel");
@@ -734,7 +1837,9 @@ namespace dmRive
         dmRender::HRenderContext render_context = context->m_RenderContext;
         RiveWorld* world = (RiveWorld*)params.m_World;
 
-        dmArray<RiveComponent*>& components = world->m_Components.GetRawObjects();
+        RenderWarmUp(context);
+
+        dmArray<RiveComponent>& components = world->m_Components.GetRawObjects();
         const uint32_t count = components.Size();
         if (!count)
         {
@@ -742,18 +1847,19 @@ namespace dmRive
         }
 
         UpdateTransforms(world);
+        RenderTargets(world);
 
         // Prepare list submit
         dmRender::RenderListEntry* render_list = dmRender::RenderListAlloc(render_context, count);
         dmRender::HRenderListDispatch dispatch = dmRender::RenderListMakeDispatch(render_context, &RenderListDispatch, world);
         dmRender::RenderListEntry* write_ptr   = render_list;
 
-        world->m_BlitMaterial = GetMaterialResource(components[0], components[0]->m_Resource);
+        world->m_BlitMaterial = GetMaterialResource(&components[0], components[0].m_Resource);
 
         for (uint32_t i = 0; i < count; ++i)
         {
-            RiveComponent& component = *components[i];
-            if (!component.m_DoRender || !component.m_Enabled)
+            RiveComponent& component = components[i];
+            if (!component.m_DoRender || !component.m_Enabled || component.m_RenderTarget)
             {
                 continue;
             }
@@ -802,7 +1908,7 @@ namespace dmRive
     dmGameObject::UpdateResult CompRiveOnMessage(const dmGameObject::ComponentOnMessageParams& params)
     {
         RiveWorld* world = (RiveWorld*)params.m_World;
-        RiveComponent* component = world->m_Components.Get(*params.m_UserData);
+        RiveComponent* component = GetComponentFromIndex(world, *params.m_UserData);
         if (params.m_Message->m_Id == dmGameObjectDDF::Enable::m_DDFDescriptor->m_NameHash)
         {
             component->m_Enabled = 1;
@@ -852,6 +1958,11 @@ namespace dmRive
             out_value.m_Variant = dmGameObject::PropertyVar(component->m_AnimationPlaybackRate);
             return dmGameObject::PROPERTY_RESULT_OK;
         }
+        else if (params.m_PropertyId == PROP_UPDATE_RATE)
+        {
+            out_value.m_Variant = dmGameObject::PropertyVar(component->m_UpdateRate);
+            return dmGameObject::PROPERTY_RESULT_OK;
+        }
         else if (params.m_PropertyId == PROP_MATERIAL)
         {
             dmGameSystem::MaterialResource* resource = GetMaterialResource(component, component->m_Resource);
@@ -862,6 +1973,15 @@ namespace dmRive
             RiveSceneData* resource = GetRiveResource(component, component->m_Resource);
             return dmGameSystem::GetResourceProperty(context->m_Factory, resource, out_value);
         }
+        else if (params.m_PropertyId == PROP_RENDER_TARGET)
+        {
+            if (!component->m_RenderTarget)
+            {
+                out_value.m_Variant = dmGameObject::PropertyVar((dmhash_t)0);
+                return dmGameObject::PROPERTY_RESULT_OK;
+            }
+            return dmGameSystem::GetResourceProperty(context->m_Factory, component->m_RenderTarget, out_value);
+        }
 
         int32_t value_index = 0;
         dmGameObject::GetPropertyOptionsIndex(params.m_Options, 0, &value_index);
@@ -871,7 +1991,7 @@ namespace dmRive
     dmGameObject::PropertyResult CompRiveSetProperty(const dmGameObject::ComponentSetPropertyParams& params)
     {
         RiveWorld* world = (RiveWorld*)params.m_World;
-        RiveComponent* component = world->m_Components.Get(*params.m_UserData);
+        RiveComponent* component = GetComponentFromIndex(world, *params.m_UserData);
         rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
 
         if (params.m_PropertyId == PROP_PLAYBACK_RATE)
@@ -882,6 +2002,14 @@ namespace dmRive
             component->m_AnimationPlaybackRate = params.m_Value.m_Number;
             return dmGameObject::PROPERTY_RESULT_OK;
         }
+        else if (params.m_PropertyId == PROP_UPDATE_RATE)
+        {
+            if (params.m_Value.m_Type != dmGameObject::PROPERTY_TYPE_NUMBER)
+                return dmGameObject::PROPERTY_RESULT_TYPE_MISMATCH;
+
+            component->m_UpdateRate = dmMath::Max(0.0f, params.m_Value.m_Number);
+            return dmGameObject::PROPERTY_RESULT_OK;
+        }
         else if (params.m_PropertyId == PROP_MATERIAL)
         {
             CompRiveContext* context = (CompRiveContext*)params.m_Context;
@@ -889,6 +2017,23 @@ namespace dmRive
             component->m_ReHash |= res == dmGameObject::PROPERTY_RESULT_OK;
             return res;
         }
+        else if (params.m_PropertyId == PROP_RENDER_TARGET)
+        {
+            CompRiveContext* context = (CompRiveContext*)params.m_Context;
+            component->m_RenderTargetDirty = 1;
+
+            // An empty hash goes back to drawing into the Rive render target
+            if (params.m_Value.m_Type == dmGameObject::PROPERTY_TYPE_HASH && params.m_Value.m_Hash == 0)
+            {
+                if (component->m_RenderTarget)
+                {
+                    dmResource::Release(context->m_Factory, (void*)component->m_RenderTarget);
+                    component->m_RenderTarget = 0;
+                }
+                return dmGameObject::PROPERTY_RESULT_OK;
+            }
+            return dmGameSystem::SetResourceProperty(context->m_Factory, params.m_Value, RENDER_TARGET_EXT_HASH, (void**)&component->m_RenderTarget);
+        }
         int32_t value_index = 0;
         dmGameObject::GetPropertyOptionsIndex(params.m_Options, 0, &value_index);
         return dmGameSystem::SetMaterialConstant(GetMaterial(component, component->m_Resource), params.m_PropertyId, params.m_Value, value_index, CompRiveSetConstantCallback, component);
@@ -897,11 +2042,11 @@ namespace dmRive
     static void ResourceReloadedCallback(const dmResource::ResourceReloadedParams* params)
     {
         RiveWorld* world = (RiveWorld*) params->m_UserData;
-        dmArray<RiveComponent*>& components = world->m_Components.GetRawObjects();
+        dmArray<RiveComponent>& components = world->m_Components.GetRawObjects();
         uint32_t n = components.Size();
         for (uint32_t i = 0; i < n; ++i)
         {
-            RiveComponent* component = components[i];
+            RiveComponent* component = &components[i];
             RiveModelResource* resource = component->m_Resource;
             if (!component->m_Enabled || !resource)
                 continue;
@@ -925,7 +2070,22 @@ namespace dmRive
         rivectx->m_Factory          = ctx->m_Factory;
         rivectx->m_GraphicsContext  = *(dmGraphics::HContext*)ctx->m_Contexts.Get(dmHashString64("graphics"));
         rivectx->m_RenderContext    = *(dmRender::HRenderContext*)ctx->m_Contexts.Get(dmHashString64("render"));
-        rivectx->m_MaxInstanceCount = dmConfigFile::GetInt(ctx->m_Config, "rive.max_instance_count", 128);
+        rivectx->m_MaxInstanceCount = dmConfigFile::GetInt(ctx->m_Config, "rive.max_instance_count", 0);
+        SetInstancePoolSize((uint32_t)dmMath::Max(0, dmConfigFile::GetInt(ctx->m_Config, "rive.instance_pool_size", 0)));
+        SetInstancePoolPrewarmCount((uint32_t)dmMath::Max(0, dmConfigFile::GetInt(ctx->m_Config, "rive.instance_pool_prewarm", 0)));
+        rivectx->m_LodScreenSize    = dmConfigFile::GetFloat(ctx->m_Config, "rive.lod_screen_size", 0.0f);
+        rivectx->m_LodUpdateRate    = dmConfigFile::GetFloat(ctx->m_Config, "rive.lod_update_rate", 15.0f);
+        rivectx->m_Culling          = dmConfigFile::GetInt(ctx->m_Config, "rive.culling", 0) != 0;
+        rivectx->m_CullingPauseAdvance = dmConfigFile::GetInt(ctx->m_Config, "rive.culling_pause_advance", 0) != 0;
+        rivectx->m_SleepSettled     = dmConfigFile::GetInt(ctx->m_Config, "rive.sleep_settled", 0) != 0;
+        rivectx->m_FrameCache       = dmConfigFile::GetInt(ctx->m_Config, "rive.frame_cache", 0) != 0;
+        rivectx->m_PartialRedraw    = dmConfigFile::GetInt(ctx->m_Config, "rive.partial_redraw", 0) != 0;
+        if (rivectx->m_PartialRedraw && !SupportsPartialRedraw(rivectx->m_RiveRenderContext))
+        {
+            dmLogWarning("'rive.partial_redraw' isn't supported by this graphics backend, and is ignored. The whole Rive frame is redrawn instead.");
+            rivectx->m_PartialRedraw = 0;
+        }
+        rivectx->m_AdvanceBudget    = (uint32_t)dmMath::Max(0, dmConfigFile::GetInt(ctx->m_Config, "rive.advance_budget_us", 0));
 
         g_RenderBeginParams.m_DoFinalBlit       = dmConfigFile::GetInt(ctx->m_Config, "rive.render_to_texture", 1);
         g_RenderBeginParams.m_BackbufferSamples = dmConfigFile::GetInt(ctx->m_Config, "display.samples", 0);
@@ -940,7 +2100,26 @@ namespace dmRive
             dmLogInfo("Render to framebuffer enabled");
         }
 
+        // The render target can't be scaled when there is no blit
+        float max_scale = dmMath::Clamp(dmConfigFile::GetFloat(ctx->m_Config, "rive.resolution_scale", 1.0f), 0.1f, 1.0f);
+        float min_scale = dmMath::Clamp(dmConfigFile::GetFloat(ctx->m_Config, "rive.resolution_min_scale", 0.5f), 0.1f, max_scale);
+        g_Resolution.m_Scale      = max_scale;
+        g_Resolution.m_MaxScale   = max_scale;
+        g_Resolution.m_MinScale   = min_scale;
+        g_Resolution.m_TargetTime = 0;
+        g_Resolution.m_RenderTime = 0;
+        g_Resolution.m_FrameCount = 0;
+        if (dmConfigFile::GetInt(ctx->m_Config, "rive.dynamic_resolution", 0))
+        {
+            g_Resolution.m_TargetTime = (uint64_t)(dmMath::Max(0.0f, dmConfigFile::GetFloat(ctx->m_Config, "rive.resolution_target_ms", 8.0f)) * 1000.0f);
+        }
+        if (g_RenderBeginParams.m_DoFinalBlit && (max_scale != 1.0f || g_Resolution.m_TargetTime != 0))
+        {
+            dmLogInfo("Resolution scale: %g (min %g, target %g ms)", max_scale, min_scale, g_Resolution.m_TargetTime / 1000.0f);
+        }
+
         g_DisplayFactor        = dmGraphics::GetDisplayScaleFactor(rivectx->m_GraphicsContext);
+        g_Context              = rivectx;
 
         dmLogInfo("Display Factor: %g", g_DisplayFactor);
 
@@ -974,6 +2153,7 @@ namespace dmRive
     static dmGameObject::Result ComponentTypeDestroy(const dmGameObject::ComponentTypeCreateCtx* ctx, dmGameObject::ComponentType* type)
     {
         CompRiveContext* rivectx = (CompRiveContext*)ComponentTypeGetContext(type);
+        g_Context = 0;
         delete rivectx;
         return dmGameObject::RESULT_OK;
     }
@@ -1015,6 +2195,12 @@ namespace dmRive
 
     rive::Vec2D WorldToLocal(RiveComponent* component, float x, float y)
     {
+        // Positions are in render target pixels, from the top left corner
+        if (component->m_RenderTarget)
+        {
+            return component->m_InverseRendererTransform * rive::Vec2D(x, y);
+        }
+
         dmGraphics::HContext graphics_context = dmGraphics::GetInstalledContext();
 
         float window_width = (float) dmGraphics::GetWindowWidth(graphics_context);
@@ -1050,6 +2236,8 @@ namespace dmRive
         rive::StateMachineHandle state_machine = component->m_StateMachine;
         rive::Vec2D p_local = WorldToLocal(component, x, y);
 
+        WakeComponent(component);
+
         queue->runOnce(
             [action, state_machine, p_local](rive::CommandServer* server)
             {
@@ -1067,6 +2255,250 @@ namespace dmRive
                     case dmRive::PointerAction::POINTER_EXIT: instance->pointerExit(p_local); break;
                 }
             });
+
+        // Don't let input wait for the next sync point
+        dmRiveCommands::Kick();
+    }
+
+    void CompRiveWakeAll()
+    {
+        ++g_WakeGeneration;
+    }
+
+    static inline uint64_t GetWakeKey(uint64_t handle, WakeHandleType type)
+    {
+        return (handle << 1) | type;
+    }
+
+    template <typename T>
+    static void PutWakeTable(dmHashTable64<T>& table, uint64_t key, T value)
+    {
+        if (table.Full())
+        {
+            uint32_t capacity = table.Capacity() + 32;
+            table.SetCapacity(dmMath::Max(7U, capacity / 2), capacity);
+        }
+        table.Put(key, value);
+    }
+
+    static void RequestWake(uint64_t key)
+    {
+        WakeRequests& wake = g_WakeRequests;
+        for (uint32_t depth = 0; depth < MAX_WAKE_LINK_DEPTH; ++depth)
+        {
+            PutWakeTable(wake.m_Requests[wake.m_Current], key, (uint8_t)1);
+            uint64_t* link = wake.m_Links.Get(key);
+            if (!link)
+            {
+                break;
+            }
+            key = *link;
+        }
+    }
+
+    static inline bool IsWakeRequested(uint64_t key)
+    {
+        return g_WakeRequests.m_Requests[0].Get(key) != 0 || g_WakeRequests.m_Requests[1].Get(key) != 0;
+    }
+
+    // Called at the start of the update of the world
+    static void ApplyWakeRequests(RiveWorld* world)
+    {
+        if (g_WakeRequests.m_Requests[0].Empty() && g_WakeRequests.m_Requests[1].Empty())
+        {
+            return;
+        }
+
+        dmArray<RiveComponent>& components = world->m_Components.GetRawObjects();
+        for (uint32_t i = 0; i < components.Size(); ++i)
+        {
+            RiveComponent& c = components[i];
+            if ((c.m_StateMachine && IsWakeRequested(GetWakeKey((uint64_t)c.m_StateMachine, WAKE_HANDLE_STATE_MACHINE))) ||
+                (c.m_ViewModelInstance && IsWakeRequested(GetWakeKey((uint64_t)c.m_ViewModelInstance, WAKE_HANDLE_VIEW_MODEL_INSTANCE))))
+            {
+                WakeComponent(&c);
+            }
+        }
+    }
+
+    void CompRiveWakeStateMachine(rive::StateMachineHandle state_machine)
+    {
+        if (state_machine)
+        {
+            RequestWake(GetWakeKey((uint64_t)state_machine, WAKE_HANDLE_STATE_MACHINE));
+        }
+    }
+
+    void CompRiveWakeViewModelInstance(rive::ViewModelInstanceHandle view_model)
+    {
+        if (view_model)
+        {
+            RequestWake(GetWakeKey((uint64_t)view_model, WAKE_HANDLE_VIEW_MODEL_INSTANCE));
+        }
+    }
+
+    void CompRiveLinkViewModelInstance(rive::ViewModelInstanceHandle view_model, rive::StateMachineHandle state_machine)
+    {
+        if (view_model && state_machine)
+        {
+            PutWakeTable(g_WakeRequests.m_Links, GetWakeKey((uint64_t)view_model, WAKE_HANDLE_VIEW_MODEL_INSTANCE),
+                         GetWakeKey((uint64_t)state_machine, WAKE_HANDLE_STATE_MACHINE));
+        }
+    }
+
+    void CompRiveLinkNestedViewModelInstance(rive::ViewModelInstanceHandle view_model, rive::ViewModelInstanceHandle parent)
+    {
+        if (view_model && parent && view_model != parent)
+        {
+            PutWakeTable(g_WakeRequests.m_Links, GetWakeKey((uint64_t)view_model, WAKE_HANDLE_VIEW_MODEL_INSTANCE),
+                         GetWakeKey((uint64_t)parent, WAKE_HANDLE_VIEW_MODEL_INSTANCE));
+        }
+    }
+
+    void CompRiveUnlinkViewModelInstance(rive::ViewModelInstanceHandle view_model)
+    {
+        uint64_t key = GetWakeKey((uint64_t)view_model, WAKE_HANDLE_VIEW_MODEL_INSTANCE);
+        if (g_WakeRequests.m_Links.Get(key))
+        {
+            g_WakeRequests.m_Links.Erase(key);
+        }
+    }
+
+    void CompRiveUpdateWake()
+    {
+        WakeRequests& wake = g_WakeRequests;
+        wake.m_Current ^= 1;
+        wake.m_Requests[wake.m_Current].Clear();
+    }
+
+    void CompRiveSetRenderTarget(dmGraphics::HRenderTarget render_target)
+    {
+        g_RenderTarget = render_target;
+    }
+
+    // The Rive render time of a frame. It is the GPU time where the graphics backend can measure it, which is a frame
+    // or more late. Otherwise it is the CPU time of the Rive frames, from their start until they were submitted,
+    // which doesn't include the GPU work. Called once per frame
+    static void TakeFrameRenderTime(FrameRenderTime* render_time)
+    {
+        render_time->m_Time  = g_FrameCpuTime;
+        render_time->m_Count = g_FrameCpuCount;
+        render_time->m_Gpu   = false;
+        g_FrameCpuTime = 0;
+        g_FrameCpuCount = 0;
+
+        uint64_t gpu_time = 0;
+        uint32_t gpu_count = 0;
+        if (g_Context && TakeGpuTime(g_Context->m_RiveRenderContext, &gpu_time, &gpu_count))
+        {
+            DM_PROPERTY_SET_U32(rmtp_RiveGpuTime, (uint32_t)gpu_time);
+            render_time->m_Time  = gpu_time;
+            render_time->m_Count = gpu_count;
+            render_time->m_Gpu   = true;
+        }
+    }
+
+    void CompRiveUpdateRenderTime()
+    {
+        TakeFrameRenderTime(&g_FrameRenderTime);
+
+        ResolutionScaling& resolution = g_Resolution;
+        if (resolution.m_TargetTime == 0 || !g_RenderBeginParams.m_DoFinalBlit)
+        {
+            return;
+        }
+
+        resolution.m_RenderTime += g_FrameRenderTime.m_Time;
+        if (++resolution.m_FrameCount < RESOLUTION_SAMPLE_FRAMES)
+        {
+            return;
+        }
+
+        float average_time = (float)resolution.m_RenderTime / (float)resolution.m_FrameCount;
+        float target_time = (float)resolution.m_TargetTime;
+        resolution.m_RenderTime = 0;
+        resolution.m_FrameCount = 0;
+
+        if (average_time <= target_time && average_time >= target_time * RESOLUTION_HEADROOM)
+        {
+            return;
+        }
+
+        // The render time is mostly proportional to the number of pixels, and the scale is aimed at the middle of the headroom
+        float scale = resolution.m_MaxScale;
+        if (average_time > 0.0f)
+        {
+            float aim_time = target_time * (1.0f + RESOLUTION_HEADROOM) * 0.5f;
+            scale = resolution.m_Scale * sqrtf(aim_time / average_time);
+            scale = floorf(scale / RESOLUTION_SCALE_STEP + 0.5f) * RESOLUTION_SCALE_STEP;
+        }
+        resolution.m_Scale = dmMath::Clamp(scale, resolution.m_MinScale, resolution.m_MaxScale);
+    }
+
+    bool CompRiveGetRenderTime(uint64_t* render_time, uint32_t* frame_count)
+    {
+        *render_time = g_FrameRenderTime.m_Time;
+        *frame_count = g_FrameRenderTime.m_Count;
+        return g_FrameRenderTime.m_Gpu;
+    }
+
+    void CompRiveSetForceFullRedraw(bool force)
+    {
+        g_ForceFullRedraw = force;
+    }
+
+    void CompRiveWarmUp(RiveSceneData* const* scenes, const char* const* artboard_names, uint32_t count, WarmUpCallback callback, void* user_data)
+    {
+        WarmUp& warm_up = g_WarmUp;
+        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        if (!warm_up.m_DrawKey)
+        {
+            warm_up.m_DrawKey = queue->createDrawKey();
+            warm_up.m_DrawCallback = [](rive::DrawKey, rive::CommandServer* server)
+            {
+                DrawWarmUp(server);
+            };
+        }
+
+        if (warm_up.m_Artboards.Remaining() < count)
+        {
+            warm_up.m_Artboards.OffsetCapacity(count - warm_up.m_Artboards.Remaining());
+        }
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            // The state machine applies the initial state, which is what is shown first
+            RiveArtboardInstance instance;
+            instance.m_Artboard = 0;
+            if (artboard_names[i] && artboard_names[i][0] != '\0')
+            {
+                instance.m_Artboard = queue->instantiateArtboardNamed(scenes[i]->m_File, artboard_names[i]);
+            }
+            if (!instance.m_Artboard)
+            {
+                instance.m_Artboard = queue->instantiateDefaultArtboard(scenes[i]->m_File);
+            }
+            instance.m_StateMachine = queue->instantiateDefaultStateMachine(instance.m_Artboard);
+            queue->advanceStateMachine(instance.m_StateMachine, 0.0f);
+            warm_up.m_Artboards.Push(instance);
+        }
+
+        if (warm_up.m_Requests.Full())
+        {
+            warm_up.m_Requests.OffsetCapacity(4);
+        }
+        WarmUpRequest request = { callback, user_data, false };
+        warm_up.m_Requests.Push(request);
+    }
+
+    void CompRiveUpdateWarmUp()
+    {
+        // A callback may queue another warm-up, for the next frame
+        dmArray<WarmUpRequest> requests;
+        requests.Swap(g_WarmUp.m_Done);
+        for (uint32_t i = 0; i < requests.Size(); ++i)
+        {
+            requests[i].m_Callback(requests[i].m_UserData, requests[i].m_WarmedUp);
+        }
     }
 
     void CompRiveDebugSetBlitMode(bool value)
@@ -20,6 +20,7 @@
 #include <dmsdk/dlib/transform.h>
 #include <dmsdk/gameobject/gameobject.h>
 #include <dmsdk/gamesys/render_constants.h>
+#include <dmsdk/graphics/graphics.h>
 
 #include "rive_ddf.h"
 
@@ -88,6 +89,40 @@ namespace dmRive
     };
 
     void CompRivePointerAction(RiveComponent* component, PointerAction cmd, float x, float y);
+
+    // Wakes all settled components, e.g. after a global asset was changed
+    void CompRiveWakeAll();
+
+    // Wakes the settled components using the state machine or view model instance, e.g. after it was changed with rive.cmd.
+    // The components are woken in the next update of their world
+    void CompRiveWakeStateMachine(rive::StateMachineHandle state_machine);
+    void CompRiveWakeViewModelInstance(rive::ViewModelInstanceHandle view_model);
+
+    // Changes to the view model instance also wake what it is bound to, or nested in. The last link of a view model instance is kept
+    void CompRiveLinkViewModelInstance(rive::ViewModelInstanceHandle view_model, rive::StateMachineHandle state_machine);
+    void CompRiveLinkNestedViewModelInstance(rive::ViewModelInstanceHandle view_model, rive::ViewModelInstanceHandle parent);
+    void CompRiveUnlinkViewModelInstance(rive::ViewModelInstanceHandle view_model);
+
+    // Drops the wake requests that every world has seen. Called once per frame
+    void CompRiveUpdateWake();
+
+    // Draws the Rive passes of the render script into the render target, instead of blitting them to the window, until it is
+    // called again. It is read when the render script's draw calls are executed. 0 restores the blit
+    void CompRiveSetRenderTarget(dmGraphics::HRenderTarget render_target);
+
+    // Measures the Rive render time of the last frame, on the GPU where the graphics backend supports it, and adjusts
+    // the dynamic resolution scale of the Rive render target to it. Called once per frame
+    void CompRiveUpdateRenderTime();
+
+    // The render time (us) measured by the last CompRiveUpdateRenderTime(), and the number of Rive frames it covers.
+    // Returns false if it was measured on the CPU, and doesn't include the GPU work
+    bool CompRiveGetRenderTime(uint64_t* render_time, uint32_t* frame_count);
+
+    // Draws the whole Rive frame every frame, without the frame cache and partial redraws, while set
+    void CompRiveSetForceFullRedraw(bool force);
+
+    // Calls the callbacks of the warm-ups drawn (or skipped) by the last render pass. Called once per frame
+    void CompRiveUpdateWarmUp();
 }
 
 #endif // DM_GAMESYS_COMP_RIVE_H
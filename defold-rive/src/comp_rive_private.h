@@ -26,6 +26,7 @@
 
 #include "rive_ddf.h"
 
+#include <rive/math/aabb.hpp>
 #include <rive/math/mat2d.hpp>
 #include <rive/refcnt.hpp>
 #include <rive/command_queue.hpp>
@@ -40,6 +41,7 @@ namespace dmGameObject
 namespace dmGameSystem
 {
     struct MaterialResource;
+    struct RenderTargetResource;
 }
 
 namespace dmRive
@@ -47,26 +49,60 @@ namespace dmRive
     struct RiveModelResource;
     struct RiveSceneData;
     struct RiveArtboardIdList;
+    struct RiveSharedInstance;
 
     // Keep this private from the scripting api
+    // The components are stored by value, and the fields read every frame by the update and render loops
+    // are kept together at the start. The rest is only touched by scripts, messages and property access.
     struct RiveComponent
     {
-        dmGameObject::HInstance                 m_Instance;
-        dmTransform::Transform                  m_Transform;
+        // Hot data
         dmVMath::Matrix4                        m_World;
-        RiveModelResource*                      m_Resource;
-        dmMessage::URL                          m_Listener;
+        dmVMath::Matrix4                        m_GameObjectWorld;  // The game object transform m_World was calculated from
+        rive::Mat2D                             m_World2D;          // m_World, for the Game coordinate system
+        dmGameObject::HInstance                 m_Instance;
         dmGameSystem::HComponentRenderConstants m_RenderConstants;
-        dmGameSystem::MaterialResource*         m_Material;
-        rive::Mat2D                             m_InverseRendererTransform;
-
+        dmGameSystem::RenderTargetResource*     m_RenderTarget;     // If set, the artboard is drawn into it instead of the Rive render target
         rive::ArtboardHandle                    m_Artboard;
         rive::StateMachineHandle                m_StateMachine;
+        float                                   m_AnimationPlaybackRate;
+        float                                   m_UpdateRate;       // Advances per second. 0 means every frame
+        float                                   m_AccumulatedDt;    // Time not yet advanced, when running below the frame rate
+        float                                   m_ScreenSize;       // Largest side of the on screen bounds, in pixels. 0 if unknown
+        uint32_t                                m_MixedHash;
+        uint32_t                                m_Id;               // Unique in the world, and kept when the component is moved in the pool
+        uint32_t                                m_AdvanceGeneration; // The wake generation when the last advance was queued
+        uint8_t                                 m_Enabled : 1;
+        uint8_t                                 m_DoRender : 1;
+        uint8_t                                 m_AddedToUpdate : 1;
+        uint8_t                                 m_ReHash : 1;
+        uint8_t                                 m_CoordGame : 1;
+        uint8_t                                 m_HasBounds : 1;
+        uint8_t                                 m_Culled : 1;
+        uint8_t                                 m_InFrame : 1;      // Drawn in the current frame of the Rive render target
+        uint8_t                                 m_Sleeping : 1;     // Settled, and not advanced until woken
+        uint8_t                                 m_Woken : 1;        // Woken since the last advance was queued
+        uint8_t                                 m_Deferred : 1;     // The last advance didn't fit in the frame budget
+        uint8_t                                 m_TransformDirty : 1; // m_World must be recalculated, even if the game object didn't move
+        uint8_t                                 m_RenderTargetDirty : 1; // m_RenderTarget must be redrawn
+        uint8_t                                 m_Settled : 1;      // The last advance had nothing more to animate
+        uint8_t                                 m_WasDrawn : 1;     // Drawn in the last frame of the Rive render target, within m_DrawnBounds
+        uint8_t                                 m_PoseChanged : 1;  // Advanced to a possibly different pose since it was last drawn
+        uint8_t                                 m_Clips : 1;        // The artboard clips its content to m_Bounds
+
+        // Cold data
+        dmTransform::Transform                  m_Transform;
+        RiveModelResource*                      m_Resource;
+        dmGameSystem::MaterialResource*         m_Material;
         rive::ViewModelInstanceHandle           m_ViewModelInstance;
-        rive::DrawKey                           m_DrawKey;
+        dmhash_t                                m_InstancePoolKey; // Non zero if the artboard and state machine go back to the pool
+        RiveSharedInstance*                     m_SharedInstance;  // Set if the handles are shared with other components
+        rive::Mat2D                             m_InverseRendererTransform;
+        rive::AABB                              m_Bounds;   // Artboard bounds, from the last time it was drawn
+        rive::AABB                              m_DrawnBounds; // Render target pixels covered the last time it was drawn
+        dmMessage::URL                          m_Listener;
 
         dmGameObject::Playback                  m_AnimationPlayback;
-        float                                   m_AnimationPlaybackRate;
 
         // dmArray<rive::Bone*>                    m_Bones;
         // dmArray<dmGameObject::HInstance>        m_BoneGOs;
@@ -76,17 +112,10 @@ namespace dmRive
 
         uint32_t                                m_VertexCount;
         uint32_t                                m_IndexCount;
-        uint32_t                                m_MixedHash;
         uint32_t                                m_CurrentViewModelInstanceRuntime;
         uint16_t                                m_HandleCounter;
         uint16_t                                m_ComponentIndex; // The component type index
         uint8_t                                 m_AnimationIndex;
-        uint8_t                                 m_Enabled : 1;
-        uint8_t                                 m_DoRender : 1;
-        uint8_t                                 m_AddedToUpdate : 1;
-        uint8_t                                 m_ReHash : 1;
-        uint8_t                                 m_CoordGame : 1;
-        uint8_t                                 : 3;
     };
 
     static const uint32_t INVALID_HANDLE = 0xFFFFFFFF;
@@ -94,6 +123,13 @@ namespace dmRive
     // Math
     rive::Vec2D     WorldToLocal(RiveComponent* component, float x, float y);
     RiveSceneData*  CompRiveGetRiveSceneData(RiveComponent* component);
+
+    // warmed_up is false if the frame wasn't drawn, since 'rive.render_to_texture' is disabled
+    typedef void (*WarmUpCallback)(void* user_data, bool warmed_up);
+    // Draws an artboard of each file once, in a frame that is never shown, so that the shaders they need
+    // are compiled before they are first drawn. The artboard names may be 0 or empty for the default artboard.
+    // The frame is drawn in the next render pass, and the callback is called at the start of the following frame
+    void            CompRiveWarmUp(RiveSceneData* const* scenes, const char* const* artboard_names, uint32_t count, WarmUpCallback callback, void* user_data);
 }
 
 #endif //DM_COMP_RIVE_PRIVATE_H
@@ -17,8 +17,16 @@
 #include <dmsdk/sdk.h>
 #include <dmsdk/extension/extension.h>
 #include <dmsdk/resource/resource.h>
+#include <dmsdk/dlib/dstrings.h>
+#include <dmsdk/dlib/math.h>
 #include <dmsdk/dlib/mutex.h>
+#include <dmsdk/dlib/sys.h>
 
+#include <stdio.h>
+#include <string.h>
+#include <algorithm> // std::sort
+
+#include "comp_rive.h"
 #include "script_rive.h"
 #include <defold/rive_version.h>
 #include "defold/renderer.h"
@@ -29,6 +37,42 @@ dmRive::HRenderContext g_RenderContext = 0;
 dmMutex::HMutex g_RenderMutex = 0;
 
 static const char* PROJECT_PROPERTY_USE_THREADS = "rive.use_threads";
+static const char* PROJECT_PROPERTY_THREAD_SPIN_TIME = "rive.thread_spin_time";
+static const char* PROJECT_PROPERTY_VULKAN_FRAMES_IN_FLIGHT = "rive.vulkan_frames_in_flight";
+static const char* PROJECT_PROPERTY_RENDER_MODE = "rive.render_mode";
+static const char* PROJECT_PROPERTY_MSAA_SAMPLES = "rive.msaa_samples";
+static const char* PROJECT_PROPERTY_CLOCKWISE_FILL = "rive.clockwise_fill";
+static const char* PROJECT_PROPERTY_SHADER_COMPILATION = "rive.shader_compilation";
+
+// Indexed by dmRive::RenderMode
+static const char* RENDER_MODE_NAMES[dmRive::RENDER_MODE_COUNT] = { "raster_ordering", "atomic", "msaa" };
+
+// Lets the shaders of a mode compile before it is timed
+static const uint32_t BENCHMARK_WARMUP_FRAMES = 10;
+static const uint32_t BENCHMARK_FRAMES        = 60;
+// The fastest mode must be this much faster than the next one for the result to be kept
+static const float    BENCHMARK_MARGIN        = 0.95f;
+// The benchmark gives up after this many engine frames, e.g. when Rive isn't drawn for long enough
+static const uint32_t BENCHMARK_MAX_FRAMES    = 1200;
+
+// With the "auto" render mode, each mode that can be switched to is timed on the first launch, by the GPU time of the
+// frames where Rive renders. Rive redraws the whole frame every frame while it runs. The fastest one is saved, together
+// with the GPU and app version it was measured with, and used from then on. It is measured again when the GPU or the
+// app version changes.
+struct RenderModeBenchmark
+{
+    char     m_Path[1024];                                              // Where the result is saved. Empty if it can't be
+    char     m_DeviceName[256];
+    char     m_AppVersion[64];
+    uint32_t m_FrameTime[dmRive::RENDER_MODE_COUNT][BENCHMARK_FRAMES];  // The Rive GPU time (us) of each timed frame
+    uint32_t m_MsaaSamples;
+    uint32_t m_Mode;                                                    // The mode being timed
+    uint32_t m_Frame;                                                   // The rendered frame of the mode being timed
+    uint32_t m_EngineFrames;                                            // The engine frames since the benchmark started
+    bool     m_Running;
+};
+
+static RenderModeBenchmark g_Benchmark;
 
 static dmExtension::Result AppInitializeRive(dmExtension::AppParams* params)
 {
@@ -49,6 +93,246 @@ static bool PlatformHasThreadSupport()
 #endif
 }
 
+static bool GetRenderModeFromName(const char* name, dmRive::RenderMode* mode)
+{
+    for (uint32_t i = 0; i < dmRive::RENDER_MODE_COUNT; ++i)
+    {
+        if (strcmp(name, RENDER_MODE_NAMES[i]) == 0)
+        {
+            *mode = (dmRive::RenderMode)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool LoadBenchmarkResult(const RenderModeBenchmark& benchmark, dmRive::RenderMode* mode)
+{
+    FILE* file = fopen(benchmark.m_Path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    // The mode, the GPU name and the app version, one per line
+    char lines[3][256];
+    uint32_t count = 0;
+    while (count < 3 && fgets(lines[count], sizeof(lines[count]), file))
+    {
+        lines[count][strcspn(lines[count], "\r\n")] = 0;
+        ++count;
+    }
+    fclose(file);
+
+    return count == 3 &&
+           strcmp(lines[1], benchmark.m_DeviceName) == 0 &&
+           strcmp(lines[2], benchmark.m_AppVersion) == 0 &&
+           GetRenderModeFromName(lines[0], mode) &&
+           dmRive::CanSwitchRenderMode(g_RenderContext, *mode);
+}
+
+static void SaveBenchmarkResult(const RenderModeBenchmark& benchmark, dmRive::RenderMode mode)
+{
+    FILE* file = fopen(benchmark.m_Path, "wb");
+    if (!file)
+    {
+        dmLogWarning("Failed to save the Rive render mode to '%s'", benchmark.m_Path);
+        return;
+    }
+    fprintf(file, "%s\n%s\n%s\n", RENDER_MODE_NAMES[mode], benchmark.m_DeviceName, benchmark.m_AppVersion);
+    fclose(file);
+}
+
+// Returns RENDER_MODE_COUNT if there is none
+static uint32_t GetNextBenchmarkMode(uint32_t mode)
+{
+    while (mode < dmRive::RENDER_MODE_COUNT && !dmRive::CanSwitchRenderMode(g_RenderContext, (dmRive::RenderMode)mode))
+    {
+        ++mode;
+    }
+    return mode;
+}
+
+static dmRive::RenderMode GetConfigRenderMode(dmConfigFile::HConfig config, bool* is_auto)
+{
+    dmRive::RenderMode mode = dmRive::RENDER_MODE_RASTER_ORDERING;
+    const char* name = dmConfigFile::GetString(config, PROJECT_PROPERTY_RENDER_MODE, RENDER_MODE_NAMES[mode]);
+    *is_auto = strcmp(name, "auto") == 0;
+    if (!*is_auto && !GetRenderModeFromName(name, &mode))
+    {
+        dmLogWarning("Unknown '%s' value '%s'. Using '%s'.", PROJECT_PROPERTY_RENDER_MODE, name, RENDER_MODE_NAMES[mode]);
+    }
+    return mode;
+}
+
+// Called once the Rive render context exists, since the GPU name and the supported modes are needed
+static void StartRenderModeBenchmark(dmConfigFile::HConfig config, uint32_t msaa_samples)
+{
+    RenderModeBenchmark& benchmark = g_Benchmark;
+    memset(&benchmark, 0, sizeof(benchmark));
+    dmStrlCpy(benchmark.m_DeviceName, dmRive::GetDeviceName(g_RenderContext), sizeof(benchmark.m_DeviceName));
+    dmStrlCpy(benchmark.m_AppVersion, dmConfigFile::GetString(config, "project.version", "1.0"), sizeof(benchmark.m_AppVersion));
+    benchmark.m_MsaaSamples = msaa_samples;
+
+    const char* title = dmConfigFile::GetString(config, "project.title", "defold");
+    char dir[sizeof(benchmark.m_Path) - 32];
+    if (dmSys::GetApplicationSupportPath(title, dir, sizeof(dir)) == dmSys::RESULT_OK)
+    {
+        dmSnPrintf(benchmark.m_Path, sizeof(benchmark.m_Path), "%s/rive_render_mode", dir);
+        dmRive::RenderMode mode;
+        if (LoadBenchmarkResult(benchmark, &mode))
+        {
+            dmRive::SetRenderMode(g_RenderContext, mode, msaa_samples);
+            return;
+        }
+    }
+
+    // The CPU time of a frame doesn't tell how long the GPU takes to draw it in each mode
+    uint64_t gpu_time;
+    uint32_t gpu_count;
+    if (!dmRive::TakeGpuTime(g_RenderContext, &gpu_time, &gpu_count))
+    {
+        dmLogInfo("The Rive render modes can't be timed, since the GPU time can't be measured with this graphics backend. Using '%s'",
+                  RENDER_MODE_NAMES[dmRive::RENDER_MODE_RASTER_ORDERING]);
+        return;
+    }
+
+    benchmark.m_Mode = GetNextBenchmarkMode(0);
+    if (benchmark.m_Mode == dmRive::RENDER_MODE_COUNT)
+    {
+        return;
+    }
+
+    dmLogInfo("Timing the Rive render modes to find the fastest one");
+    dmRive::SetRenderMode(g_RenderContext, (dmRive::RenderMode)benchmark.m_Mode, msaa_samples);
+    dmRive::CompRiveSetForceFullRedraw(true);
+    benchmark.m_Running = true;
+}
+
+// Nothing is saved, so the modes are timed again on the next launch
+static void StopRenderModeBenchmark()
+{
+    RenderModeBenchmark& benchmark = g_Benchmark;
+    benchmark.m_Running = false;
+    dmRive::CompRiveSetForceFullRedraw(false);
+    dmRive::SetRenderMode(g_RenderContext, dmRive::RENDER_MODE_RASTER_ORDERING, benchmark.m_MsaaSamples);
+}
+
+// The median is used, since it isn't thrown off by the occasional hitch
+static uint32_t GetMedianFrameTime(uint32_t* frame_times)
+{
+    std::sort(frame_times, frame_times + BENCHMARK_FRAMES);
+    return frame_times[BENCHMARK_FRAMES / 2];
+}
+
+static void FinishRenderModeBenchmark()
+{
+    RenderModeBenchmark& benchmark = g_Benchmark;
+    benchmark.m_Running = false;
+    dmRive::CompRiveSetForceFullRedraw(false);
+
+    uint32_t best = dmRive::RENDER_MODE_COUNT;
+    uint32_t second = dmRive::RENDER_MODE_COUNT;
+    uint32_t median[dmRive::RENDER_MODE_COUNT];
+    for (uint32_t i = GetNextBenchmarkMode(0); i < dmRive::RENDER_MODE_COUNT; i = GetNextBenchmarkMode(i + 1))
+    {
+        median[i] = GetMedianFrameTime(benchmark.m_FrameTime[i]);
+        dmLogInfo("Rive render mode '%s': %.2f ms per frame", RENDER_MODE_NAMES[i], median[i] / 1000.0f);
+        if (best == dmRive::RENDER_MODE_COUNT || median[i] < median[best])
+        {
+            second = best;
+            best = i;
+        }
+        else if (second == dmRive::RENDER_MODE_COUNT || median[i] < median[second])
+        {
+            second = i;
+        }
+    }
+
+    // Within the noise, the default mode is kept, and the modes are timed again on the next launch
+    if (second != dmRive::RENDER_MODE_COUNT && median[best] >= median[second] * BENCHMARK_MARGIN)
+    {
+        dmLogInfo("The Rive render modes are too close to tell apart. Using '%s'", RENDER_MODE_NAMES[dmRive::RENDER_MODE_RASTER_ORDERING]);
+        StopRenderModeBenchmark();
+        return;
+    }
+
+    dmLogInfo("Using the Rive render mode '%s'", RENDER_MODE_NAMES[best]);
+    dmRive::SetRenderMode(g_RenderContext, (dmRive::RenderMode)best, benchmark.m_MsaaSamples);
+    if (benchmark.m_Path[0])
+    {
+        SaveBenchmarkResult(benchmark, (dmRive::RenderMode)best);
+    }
+}
+
+static void UpdateRenderModeBenchmark()
+{
+    RenderModeBenchmark& benchmark = g_Benchmark;
+    if (!benchmark.m_Running)
+    {
+        return;
+    }
+
+    if (++benchmark.m_EngineFrames > BENCHMARK_MAX_FRAMES)
+    {
+        dmLogInfo("The Rive render modes couldn't be timed within %u frames. Using '%s'", BENCHMARK_MAX_FRAMES,
+                  RENDER_MODE_NAMES[dmRive::RENDER_MODE_RASTER_ORDERING]);
+        StopRenderModeBenchmark();
+        return;
+    }
+
+    // Only the frames where Rive rendered something are timed. The engine frame time would be capped by the vsync.
+    // The GPU time arrives a frame or more late, which the warm-up frames of each mode leave out.
+    uint64_t render_time;
+    uint32_t frame_count;
+    if (!dmRive::CompRiveGetRenderTime(&render_time, &frame_count))
+    {
+        dmLogInfo("The Rive GPU time is no longer measured. Using '%s'", RENDER_MODE_NAMES[dmRive::RENDER_MODE_RASTER_ORDERING]);
+        StopRenderModeBenchmark();
+        return;
+    }
+    if (frame_count == 0)
+    {
+        return;
+    }
+
+    if (benchmark.m_Frame >= BENCHMARK_WARMUP_FRAMES)
+    {
+        benchmark.m_FrameTime[benchmark.m_Mode][benchmark.m_Frame - BENCHMARK_WARMUP_FRAMES] = (uint32_t)render_time;
+    }
+
+    if (++benchmark.m_Frame < BENCHMARK_WARMUP_FRAMES + BENCHMARK_FRAMES)
+    {
+        return;
+    }
+
+    benchmark.m_Frame = 0;
+    benchmark.m_Mode = GetNextBenchmarkMode(benchmark.m_Mode + 1);
+    if (benchmark.m_Mode < dmRive::RENDER_MODE_COUNT)
+    {
+        dmRive::SetRenderMode(g_RenderContext, (dmRive::RenderMode)benchmark.m_Mode, benchmark.m_MsaaSamples);
+        return;
+    }
+
+    FinishRenderModeBenchmark();
+}
+
+// "default" keeps the mode chosen by the graphics backend
+static void SetConfigShaderCompilation(dmConfigFile::HConfig config)
+{
+    const char* name = dmConfigFile::GetString(config, PROJECT_PROPERTY_SHADER_COMPILATION, "default");
+    if (name[0] == '\0' || strcmp(name, "default") == 0)
+        return;
+    else if (strcmp(name, "async") == 0)
+        dmRive::SetShaderCompilation(g_RenderContext, dmRive::SHADER_COMPILATION_ASYNC);
+    else if (strcmp(name, "sync") == 0)
+        dmRive::SetShaderCompilation(g_RenderContext, dmRive::SHADER_COMPILATION_SYNC);
+    else if (strcmp(name, "ubershaders") == 0)
+        dmRive::SetShaderCompilation(g_RenderContext, dmRive::SHADER_COMPILATION_UBERSHADERS);
+    else
+        dmLogWarning("Unknown '%s' value '%s'", PROJECT_PROPERTY_SHADER_COMPILATION, name);
+}
+
 static dmExtension::Result InitializeRive(dmExtension::Params* params)
 {
     g_RenderContext = dmRive::NewRenderContext();
@@ -57,23 +341,68 @@ static dmExtension::Result InitializeRive(dmExtension::Params* params)
     assert(g_RenderMutex != 0);
     dmRive::SetRenderMutex(g_RenderContext, g_RenderMutex);
 
-    // We need to secure multi thread rendering before supporting this feature.
-    bool use_threads = false;
-    //bool use_threads = PlatformHasThreadSupport() &&
-    //                    dmConfigFile::GetInt(params->m_ConfigFile, PROJECT_PROPERTY_USE_THREADS, 0) > 0;
+    // Before the Rive render context is created by GetRiveFactory()
+    uint32_t msaa_samples = (uint32_t)dmMath::Clamp(dmConfigFile::GetInt(params->m_ConfigFile, PROJECT_PROPERTY_MSAA_SAMPLES, 4), 1, 16);
+    bool auto_render_mode = false;
+    dmRive::SetRenderMode(g_RenderContext, GetConfigRenderMode(params->m_ConfigFile, &auto_render_mode), msaa_samples);
+    dmRive::SetClockwiseFillOverride(g_RenderContext, dmConfigFile::GetInt(params->m_ConfigFile, PROJECT_PROPERTY_CLOCKWISE_FILL, 0) != 0);
+    SetConfigShaderCompilation(params->m_ConfigFile);
+    dmRive::SetFramesInFlight(g_RenderContext, (uint32_t)dmMath::Max(1, dmConfigFile::GetInt(params->m_ConfigFile, PROJECT_PROPERTY_VULKAN_FRAMES_IN_FLIGHT, 2)));
+
+    bool use_threads = PlatformHasThreadSupport() &&
+                        dmConfigFile::GetInt(params->m_ConfigFile, PROJECT_PROPERTY_USE_THREADS, 0) > 0;
+
+#if defined(DM_RIVE_USE_OPENGL)
+    // The command server creates render resources (buffers, gradients, images) while processing commands,
+    // and the OpenGL context is only current on the main thread.
+    if (use_threads)
+    {
+        dmLogWarning("'%s' is not supported with the OpenGL renderer. Running Rive commands on the main thread.", PROJECT_PROPERTY_USE_THREADS);
+        use_threads = false;
+    }
+#endif
 
     dmRiveCommands::InitParams cmd_params;
     cmd_params.m_UseThreads = use_threads;
+    cmd_params.m_SpinTime = (uint32_t)dmMath::Max(0, dmConfigFile::GetInt(params->m_ConfigFile, PROJECT_PROPERTY_THREAD_SPIN_TIME, 0));
     cmd_params.m_RenderContext = g_RenderContext;
     cmd_params.m_Factory = dmRive::GetRiveFactory(g_RenderContext);
     cmd_params.m_Mutex = g_RenderMutex;
-    dmRiveCommands::Initialize(&cmd_params);
+    dmRiveCommands::Result cmd_result = dmRiveCommands::Initialize(&cmd_params);
+    if (cmd_result == dmRiveCommands::RESULT_FAILED_CREATE_THREAD)
+    {
+        dmLogWarning("Failed to create the Rive command thread. Running Rive commands on the main thread.");
+        cmd_params.m_UseThreads = false;
+        cmd_result = dmRiveCommands::Initialize(&cmd_params);
+    }
+    if (cmd_result != dmRiveCommands::RESULT_OK)
+    {
+        dmLogError("Failed to initialize the Rive command queue");
+        return dmExtension::RESULT_INIT_ERROR;
+    }
+
+    if (auto_render_mode)
+    {
+        StartRenderModeBenchmark(params->m_ConfigFile, msaa_samples);
+    }
 
     // relies on the command queue for registering listeners
     dmResource::HFactory factory = dmExtension::GetContextAsType<dmResource::HFactory>(params, "factory");
     dmRive::ScriptRegister(params->m_L, factory);
 
-    dmLogInfo("Registered Rive extension:  %s  %s\n", RIVE_RUNTIME_DATE, RIVE_RUNTIME_SHA1);
+    dmLogInfo("Registered Rive extension:  %s  %s%s\n", RIVE_RUNTIME_DATE, RIVE_RUNTIME_SHA1, cmd_params.m_UseThreads ? "  (threaded)" : "");
+    return dmExtension::RESULT_OK;
+}
+
+static dmExtension::Result UpdateRive(dmExtension::Params* params)
+{
+    // The single point per frame where listener callbacks are delivered to the scripts.
+    // When running single threaded, this also processes any commands queued outside of the component update.
+    dmRiveCommands::PollMessages();
+    dmRive::CompRiveUpdateRenderTime();
+    dmRive::CompRiveUpdateWake();
+    UpdateRenderModeBenchmark();
+    dmRive::CompRiveUpdateWarmUp();
     return dmExtension::RESULT_OK;
 }
 
@@ -98,4 +427,4 @@ static dmExtension::Result AppFinalizeRive(dmExtension::AppParams* params)
     return dmExtension::RESULT_OK;
 }
 
-DM_DECLARE_EXTENSION(RiveExt, "RiveExt", AppInitializeRive, AppFinalizeRive, InitializeRive, 0, 0, FinalizeRive);
+DM_DECLARE_EXTENSION(RiveExt, "RiveExt", AppInitializeRive, AppFinalizeRive, InitializeRive, UpdateRive, 0, FinalizeRive);
@@ -14,6 +14,7 @@
 
 #include <dmsdk/dlib/hash.h>
 #include <dmsdk/dlib/log.h>
+#include <dmsdk/dlib/math.h>
 #include <dmsdk/extension/extension.h>
 #include <dmsdk/resource/resource.h>
 
@@ -25,10 +26,175 @@
 #include <common/commands.h>
 
 #include <stdint.h>
+#include <string.h> // strlen
 #include <vector>
 
 namespace dmRive
 {
+    static uint32_t g_InstancePoolSize = 0;
+    static uint32_t g_InstancePoolPrewarmCount = 0;
+
+    void SetInstancePoolSize(uint32_t size)
+    {
+        g_InstancePoolSize = size;
+    }
+
+    uint32_t GetInstancePoolSize()
+    {
+        return g_InstancePoolSize;
+    }
+
+    void SetInstancePoolPrewarmCount(uint32_t count)
+    {
+        g_InstancePoolPrewarmCount = count;
+    }
+
+    uint32_t GetInstancePoolPrewarmCount()
+    {
+        return g_InstancePoolPrewarmCount;
+    }
+
+    dmhash_t GetInstancePoolKey(const char* artboard_name, const char* state_machine_name)
+    {
+        artboard_name = artboard_name ? artboard_name : "";
+        state_machine_name = state_machine_name ? state_machine_name : "";
+
+        HashState64 state;
+        dmHashInit64(&state, false);
+        dmHashUpdateBuffer64(&state, artboard_name, strlen(artboard_name));
+        dmHashUpdateBuffer64(&state, "/", 1);
+        dmHashUpdateBuffer64(&state, state_machine_name, strlen(state_machine_name));
+        return dmHashFinal64(&state);
+    }
+
+    static rive::StateMachineHandle InstantiateStateMachine(rive::rcp<rive::CommandQueue> queue, rive::ArtboardHandle artboard, const char* state_machine_name)
+    {
+        rive::StateMachineHandle state_machine = 0;
+        if (state_machine_name && state_machine_name[0] != '\0')
+        {
+            state_machine = queue->instantiateStateMachineNamed(artboard, state_machine_name);
+        }
+        if (!state_machine)
+        {
+            state_machine = queue->instantiateDefaultStateMachine(artboard);
+        }
+        return state_machine;
+    }
+
+    static RiveArtboardInstanceList* GetInstanceList(RiveSceneData* scene_data, dmhash_t key, bool create)
+    {
+        RiveArtboardInstanceList** list = scene_data->m_InstancePool.Get(key);
+        if (list)
+        {
+            return *list;
+        }
+        if (!create)
+        {
+            return 0;
+        }
+
+        if (scene_data->m_InstancePool.Full())
+        {
+            uint32_t capacity = scene_data->m_InstancePool.Capacity() + 8;
+            scene_data->m_InstancePool.SetCapacity(dmMath::Max(7U, capacity / 2), capacity);
+        }
+        RiveArtboardInstanceList* new_list = new RiveArtboardInstanceList;
+        new_list->SetCapacity(g_InstancePoolSize);
+        scene_data->m_InstancePool.Put(key, new_list);
+        return new_list;
+    }
+
+    bool AcquirePooledInstance(RiveSceneData* scene_data, dmhash_t key, RiveArtboardInstance* out_instance)
+    {
+        RiveArtboardInstanceList* list = GetInstanceList(scene_data, key, false);
+        if (!list || list->Empty())
+        {
+            return false;
+        }
+        *out_instance = list->Back();
+        list->Pop();
+        return true;
+    }
+
+    bool ReleasePooledInstance(RiveSceneData* scene_data, dmhash_t key, const char* state_machine_name, const RiveArtboardInstance& instance)
+    {
+        if (g_InstancePoolSize == 0)
+        {
+            return false;
+        }
+
+        RiveArtboardInstanceList* list = GetInstanceList(scene_data, key, true);
+        if (list->Size() >= g_InstancePoolSize)
+        {
+            return false;
+        }
+        if (list->Full())
+        {
+            list->OffsetCapacity(g_InstancePoolSize - list->Capacity());
+        }
+
+        // The state machine is replaced, so that the next user starts from the initial state.
+        // Its first advance also applies the initial state to the artboard.
+        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        queue->deleteStateMachine(instance.m_StateMachine);
+
+        RiveArtboardInstance reset_instance;
+        reset_instance.m_Artboard = instance.m_Artboard;
+        reset_instance.m_StateMachine = InstantiateStateMachine(queue, instance.m_Artboard, state_machine_name);
+        list->Push(reset_instance);
+        return true;
+    }
+
+    void PrewarmInstancePool(RiveSceneData* scene_data, const char* artboard_name, const char* state_machine_name, uint32_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        RiveArtboardInstanceList* list = GetInstanceList(scene_data, GetInstancePoolKey(artboard_name, state_machine_name), true);
+        if (list->Capacity() < count)
+        {
+            list->SetCapacity(count);
+        }
+
+        while (list->Size() < count)
+        {
+            RiveArtboardInstance instance;
+            instance.m_Artboard = 0;
+            if (artboard_name && artboard_name[0] != '\0')
+            {
+                instance.m_Artboard = queue->instantiateArtboardNamed(scene_data->m_File, artboard_name);
+            }
+            if (!instance.m_Artboard)
+            {
+                instance.m_Artboard = queue->instantiateDefaultArtboard(scene_data->m_File);
+            }
+            instance.m_StateMachine = InstantiateStateMachine(queue, instance.m_Artboard, state_machine_name);
+            queue->advanceStateMachine(instance.m_StateMachine, 0.0f);
+            list->Push(instance);
+        }
+    }
+
+    static void DeleteInstanceList(void*, const dmhash_t*, RiveArtboardInstanceList** value)
+    {
+        rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        RiveArtboardInstanceList* list = *value;
+        for (uint32_t i = 0; i < list->Size(); ++i)
+        {
+            queue->deleteStateMachine((*list)[i].m_StateMachine);
+            queue->deleteArtboard((*list)[i].m_Artboard);
+        }
+        delete list;
+    }
+
+    static void ClearInstancePool(RiveSceneData* scene_data)
+    {
+        scene_data->m_InstancePool.Iterate(DeleteInstanceList, (void*)0);
+        scene_data->m_InstancePool.Clear();
+    }
+
     static rive::FileHandle LoadFile(rive::rcp<rive::CommandQueue> queue, const char* path, const void* data, uint32_t data_size, RiveSceneData* scene_data)
     {
         // RIVE: Currently their api doesn't support passing the bytes directly, but require you to make a copy of it.
@@ -74,6 +240,7 @@ namespace dmRive
     static void DeleteData(RiveSceneData* scene_data)
     {
         rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
+        ClearInstancePool(scene_data);
         queue->deleteFile(scene_data->m_File);
         delete scene_data;
     }
@@ -102,6 +269,9 @@ namespace dmRive
         RiveSceneData* old_data = (RiveSceneData*)dmResource::GetResource(params->m_Resource);
         assert(old_data != 0);
 
+        // The pooled instances belong to the old file
+        ClearInstancePool(old_data);
+
         // We don't want to delete the old resource, as the pointer may be "live"
         rive::FileHandle tmp_handle = scene_data->m_File;
         scene_data->m_File = old_data->m_File;
@@ -14,6 +14,9 @@
 #define DM_RES_RIVE_DATA_H
 
 #include <stdint.h>
+#include <dmsdk/dlib/array.h>
+#include <dmsdk/dlib/hash.h>
+#include <dmsdk/dlib/hashtable.h>
 #include "defold/renderer.h"
 
 #include <rive/refcnt.hpp>
@@ -21,12 +24,39 @@
 
 namespace dmRive
 {
+    struct RiveArtboardInstance
+    {
+        rive::ArtboardHandle     m_Artboard;
+        rive::StateMachineHandle m_StateMachine;
+    };
+
+    typedef dmArray<RiveArtboardInstance> RiveArtboardInstanceList;
+
     struct RiveSceneData
     {
         dmhash_t         m_PathHash;
         rive::FileHandle m_File;
         HRenderContext   m_RiveRenderContext;
+        // Released artboard instances, ready for reuse. Keyed on the artboard and state machine names
+        dmHashTable64<RiveArtboardInstanceList*> m_InstancePool;
     };
+
+    // Artboard instance pooling. The pool size is the max number of instances kept per artboard and state machine
+    void     SetInstancePoolSize(uint32_t size);
+    uint32_t GetInstancePoolSize();
+    // The number of instances put in the pool when a rive model is loaded
+    void     SetInstancePoolPrewarmCount(uint32_t count);
+    uint32_t GetInstancePoolPrewarmCount();
+    dmhash_t GetInstancePoolKey(const char* artboard_name, const char* state_machine_name);
+    // Takes an instance from the pool. Returns false if there was none
+    bool     AcquirePooledInstance(RiveSceneData* scene_data, dmhash_t key, RiveArtboardInstance* out_instance);
+    // Puts the instance back in the pool, with a new state machine. Returns false if the pool is full,
+    // and the caller still owns the instance
+    bool     ReleasePooledInstance(RiveSceneData* scene_data, dmhash_t key, const char* state_machine_name, const RiveArtboardInstance& instance);
+    // Instantiates artboards until there are at least count instances in the pool, and advances
+    // them once, so that the first use doesn't pay for the instantiation, layout and text shaping.
+    // Prewarmed instances are reused even if the pool size is 0
+    void     PrewarmInstancePool(RiveSceneData* scene_data, const char* artboard_name, const char* state_machine_name, uint32_t count);
 }
 
 #endif // DM_RES_RIVE_DATA_H
@@ -13,6 +13,8 @@
 #if !defined(DM_RIVE_UNSUPPORTED)
 
 #include "res_rive_model.h"
+#include "res_rive_scene.h"
+#include "res_rive_data.h"
 
 #include <dmsdk/dlib/log.h>
 #include <dmsdk/resource/resource.h>
@@ -32,6 +34,9 @@ namespace dmRive
         {
             return result;
         }
+
+        // Have instances ready for the components spawned by factories
+        PrewarmInstancePool(resource->m_Scene->m_Scene, resource->m_DDF->m_Artboard, resource->m_DDF->m_DefaultStateMachine, GetInstancePoolPrewarmCount());
         return dmResource::RESULT_OK;
     }
 
@@ -14,13 +14,51 @@
 
 #include "res_rive_scene.h"
 
+#include <dmsdk/dlib/dstrings.h>
 #include <dmsdk/dlib/log.h>
 #include <dmsdk/resource/resource.h>
 
+#include <stdlib.h> // free
+#include <string.h> // strdup
+
 #include "defold/renderer.h"
+#include "res_rive_data.h"
 
 namespace dmRive
 {
+    // Fills the instance pool of the file with the artboards listed in the scene
+    static void PrewarmScene(RiveSceneResource* resource)
+    {
+        dmRiveDDF::RiveSceneDesc* ddf = resource->m_DDF;
+        if (ddf->m_PrewarmCount == 0)
+        {
+            return;
+        }
+
+        const char* state_machine = ddf->m_PrewarmStateMachine;
+        const char* artboards = ddf->m_PrewarmArtboards;
+        if (artboards[0] == '\0')
+        {
+            PrewarmInstancePool(resource->m_Scene, "", state_machine, ddf->m_PrewarmCount);
+            return;
+        }
+
+        char* names = strdup(artboards);
+        char* last = 0;
+        char* name = dmStrTok(names, ",", &last);
+        while (name)
+        {
+            while (*name == ' ')
+                ++name;
+            char* end = name + strlen(name);
+            while (end > name && end[-1] == ' ')
+                *--end = '\0';
+            PrewarmInstancePool(resource->m_Scene, name, state_machine, ddf->m_PrewarmCount);
+            name = dmStrTok(0, ",", &last);
+        }
+        free(names);
+    }
+
     static dmResource::Result AcquireResources(dmResource::HFactory factory, RiveSceneResource* resource, const char* filename)
     {
         // The rive file (.riv)
@@ -32,6 +70,8 @@ namespace dmRive
 
         resource->m_TextureSet = 0;
 
+        PrewarmScene(resource);
+
         if (resource->m_DDF->m_Atlas[0] != 0)
         {
             dmLogWarning("The atlas property is deprected and ignored (%s): '%s'", filename, resource->m_DDF->m_Atlas);
@@ -24,6 +24,7 @@
 
 #include <dmsdk/sdk.h>
 #include <dmsdk/dlib/hash.h>
+#include <dmsdk/dlib/math.h>
 #include <dmsdk/dlib/message.h>
 #include <dmsdk/dlib/vmath.h>
 #include <dmsdk/gameobject/script.h>
@@ -35,6 +36,7 @@
 #include "comp_rive_private.h"
 #include "rive_ddf.h"
 #include "res_rive_data.h"
+#include "res_rive_model.h"
 
 #include "script_rive.h"
 #include "script_rive_cmd.h"
@@ -43,6 +45,8 @@
 
 #include <common/commands.h>
 
+#include <string.h> // strrchr
+
 namespace dmRive
 {
 static const char*    RIVE_EXT      = "rivc";
@@ -139,6 +143,38 @@ static int Script_GetProjectionMatrix(lua_State* L)
     return 1;
 }
 
+/**
+ * Draws the Rive models straight into a render target, instead of into the Rive render target that is then
+ * blitted to the window. This saves the blit and the window sized texture. The view is scaled to the render
+ * target the same way it is to the window.
+ * The setting is kept until it is changed, and applies to every Rive pass drawn from then on. The render.draw()
+ * calls of a render script are only executed once its update has returned, so it can't be changed between
+ * two of them: the last value set in the update is the one used for the whole frame.
+ * On OpenGL, Rive is drawn on top of what the render script drew into the target before. On the other
+ * graphics backends the Rive frame is submitted ahead of the rest of the frame, so the target is cleared,
+ * and the render script shouldn't draw into it before Rive in the same frame.
+ * @name rive.set_render_target(render_target)
+ * @param render_target [type: handle|nil] A render target created with render.render_target(), or nil to draw to the window again.
+ */
+static int Script_SetRenderTarget(lua_State* L)
+{
+    DM_LUA_STACK_CHECK(L, 0);
+
+    dmGraphics::HRenderTarget render_target = 0;
+    if (!lua_isnil(L, 1))
+    {
+        // Render target handles are passed to Lua as numbers, see render.render_target()
+        render_target = (dmGraphics::HRenderTarget)(uint64_t) luaL_checknumber(L, 1);
+        if (dmGraphics::GetAssetType(render_target) != dmGraphics::ASSET_TYPE_RENDER_TARGET ||
+            !dmGraphics::IsAssetHandleValid(dmGraphics::GetInstalledContext(), render_target))
+        {
+            return DM_LUA_ERROR("The first argument must be a render target created with render.render_target(), or nil");
+        }
+    }
+    CompRiveSetRenderTarget(render_target);
+    return 0;
+}
+
 // This is an "all bets are off" mode.
 static int Script_DebugSetBlitMode(lua_State* L)
 {
@@ -486,6 +522,221 @@ static int Script_GetViewModelInstance(lua_State* L)
     return 1;
 }
 
+// Tells a file path from a component url string
+static bool IsRiveFilePath(const char* path)
+{
+    const char* ext = strrchr(path, '.');
+    return ext && strcmp(ext + 1, RIVE_EXT) == 0;
+}
+
+/**
+ * Instantiates artboards ahead of time, e.g. while loading a level. The instances are advanced once,
+ * and kept in the instance pool of the file. They are used by the next Rive models created
+ * with the same artboard and state machine, so that spawning them doesn't cause a hitch.
+ * The file must stay loaded for the instances to be kept.
+ * @name rive.prewarm(url_or_file, options)
+ * @param url_or_file [type: url|string] A Rive model component, or the path of a loaded Rive file (e.g. "/main/hero.rivc").
+ * @param options [type: table|nil] Optional settings:
+ *   - `artboards`: [type:table|string] Artboard names. Defaults to the artboard of the component, or the default artboard.
+ *   - `state_machine`: [type:string] State machine name. Defaults to the state machine of the component, or the default state machine.
+ *   - `count`: [type:number] Number of instances per artboard. Defaults to 1.
+ */
+static int Script_Prewarm(lua_State* L)
+{
+    DM_LUA_STACK_CHECK(L, 0);
+
+    const char* file_path = 0;
+    RiveComponent* component = 0;
+    const char* artboard = "";
+    const char* state_machine = "";
+    if (lua_type(L, 1) == LUA_TSTRING && IsRiveFilePath(lua_tostring(L, 1)))
+    {
+        file_path = lua_tostring(L, 1);
+    }
+    else
+    {
+        dmScript::GetComponentFromLua(L, 1, dmRive::RIVE_MODEL_EXT, 0, (void**)&component, 0);
+        artboard = component->m_Resource->m_DDF->m_Artboard;
+        state_machine = component->m_Resource->m_DDF->m_DefaultStateMachine;
+    }
+
+    uint32_t count = 1;
+    int artboards_index = 0;
+    if (lua_istable(L, 2))
+    {
+        lua_getfield(L, 2, "count");
+        if (!lua_isnil(L, -1))
+            count = (uint32_t)dmMath::Max(0, (int)luaL_checkinteger(L, -1));
+        lua_pop(L, 1);
+
+        lua_getfield(L, 2, "state_machine");
+        if (!lua_isnil(L, -1))
+            state_machine = luaL_checkstring(L, -1);
+        lua_pop(L, 1); // the string is still referenced by the options table
+
+        lua_getfield(L, 2, "artboards");
+        if (lua_type(L, -1) == LUA_TSTRING)
+            artboard = lua_tostring(L, -1);
+        else if (lua_istable(L, -1))
+            artboards_index = lua_gettop(L);
+        else if (!lua_isnil(L, -1))
+            return DM_LUA_ERROR("'artboards' must be a string or a table of strings");
+        if (!artboards_index)
+            lua_pop(L, 1);
+    }
+
+    RiveSceneData* scene_data = 0;
+    void* file_resource = 0;
+    if (file_path)
+    {
+        dmResource::Result r = dmResource::GetWithExt(g_Factory, file_path, RIVE_EXT, &file_resource);
+        if (r != dmResource::RESULT_OK)
+        {
+            return DM_LUA_ERROR("Could not get the Rive file '%s': %d", file_path, r);
+        }
+        scene_data = (RiveSceneData*)file_resource;
+    }
+    else
+    {
+        scene_data = CompRiveGetRiveSceneData(component);
+    }
+
+    if (artboards_index)
+    {
+        uint32_t num_artboards = (uint32_t)lua_objlen(L, artboards_index);
+        for (uint32_t i = 1; i <= num_artboards; ++i)
+        {
+            lua_rawgeti(L, artboards_index, i);
+            if (lua_type(L, -1) == LUA_TSTRING)
+                PrewarmInstancePool(scene_data, lua_tostring(L, -1), state_machine, count);
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+    }
+    else
+    {
+        PrewarmInstancePool(scene_data, artboard, state_machine, count);
+    }
+
+    // The pool is kept with the file, as long as something else holds on to it
+    if (file_resource)
+    {
+        dmResource::Release(g_Factory, file_resource);
+    }
+    return 0;
+}
+
+struct WarmUpRequest
+{
+    dmScript::LuaCallbackInfo* m_Callback;
+    dmArray<void*>             m_FileResources; // Released when the warm-up is done
+};
+
+static void OnWarmUpDone(void* user_data, bool warmed_up)
+{
+    WarmUpRequest* request = (WarmUpRequest*)user_data;
+    if (request->m_Callback)
+    {
+        if (dmScript::IsCallbackValid(request->m_Callback) && dmScript::SetupCallback(request->m_Callback))
+        {
+            lua_State* L = dmScript::GetCallbackLuaContext(request->m_Callback);
+            lua_pushboolean(L, warmed_up);
+            dmScript::PCall(L, 2, 0); // self, warmed_up
+            dmScript::TeardownCallback(request->m_Callback);
+        }
+        dmScript::DestroyCallback(request->m_Callback);
+    }
+
+    for (uint32_t i = 0; i < request->m_FileResources.Size(); ++i)
+    {
+        dmResource::Release(g_Factory, request->m_FileResources[i]);
+    }
+    delete request;
+}
+
+/**
+ * Compiles the shaders used by Rive files ahead of time, e.g. during a loading screen, so that the first frames
+ * drawing them don't stall. An artboard of each file is drawn once, in a frame that isn't shown.
+ * How much is compiled by the warm-up depends on the `rive.shader_compilation` project setting.
+ * @name rive.warm_up(urls_or_files, callback)
+ * @param urls_or_files [type: url|string|table] A Rive model component, the path of a loaded Rive file (e.g. "/main/hero.rivc"), or a table of them.
+ *   The artboard of the component is drawn, or the default artboard of the file.
+ * @param callback [type: function(self, warmed_up)|nil] Called at the start of the frame after the warm-up frame was drawn, in the render pass.
+ *   `warmed_up` is false if the warm-up was skipped, since the `rive.render_to_texture` project setting is disabled.
+ */
+static int Script_WarmUp(lua_State* L)
+{
+    DM_LUA_STACK_CHECK(L, 0);
+
+    bool has_callback = !lua_isnoneornil(L, 2);
+    if (has_callback)
+    {
+        luaL_checktype(L, 2, LUA_TFUNCTION);
+    }
+
+    dmArray<RiveSceneData*> scenes;
+    dmArray<const char*> artboards;
+    dmArray<const char*> file_paths;
+
+    int table_index = lua_istable(L, 1) ? 1 : 0;
+    uint32_t count = table_index ? (uint32_t)lua_objlen(L, 1) : 1;
+    scenes.SetCapacity(count);
+    artboards.SetCapacity(count);
+    file_paths.SetCapacity(count);
+
+    // The components are resolved first, since that raises a Lua error if one can't be found
+    for (uint32_t i = 1; i <= count; ++i)
+    {
+        int index = 1;
+        if (table_index)
+        {
+            lua_rawgeti(L, table_index, i);
+            index = lua_gettop(L);
+        }
+
+        if (lua_type(L, index) == LUA_TSTRING && IsRiveFilePath(lua_tostring(L, index)))
+        {
+            file_paths.Push(lua_tostring(L, index)); // still referenced by the table
+        }
+        else
+        {
+            RiveComponent* component = 0;
+            dmScript::GetComponentFromLua(L, index, dmRive::RIVE_MODEL_EXT, 0, (void**)&component, 0);
+            scenes.Push(CompRiveGetRiveSceneData(component));
+            artboards.Push(component->m_Resource->m_DDF->m_Artboard);
+        }
+
+        if (table_index)
+        {
+            lua_pop(L, 1);
+        }
+    }
+
+    WarmUpRequest* request = new WarmUpRequest;
+    request->m_Callback = 0;
+    request->m_FileResources.SetCapacity(file_paths.Size());
+    for (uint32_t i = 0; i < file_paths.Size(); ++i)
+    {
+        void* file_resource = 0;
+        dmResource::Result r = dmResource::GetWithExt(g_Factory, file_paths[i], RIVE_EXT, &file_resource);
+        if (r != dmResource::RESULT_OK)
+        {
+            OnWarmUpDone(request, false);
+            return DM_LUA_ERROR("Could not get the Rive file '%s': %d", file_paths[i], r);
+        }
+        request->m_FileResources.Push(file_resource);
+        scenes.Push((RiveSceneData*)file_resource);
+        artboards.Push("");
+    }
+
+    if (has_callback)
+    {
+        request->m_Callback = dmScript::CreateCallback(L, 2);
+    }
+
+    CompRiveWarmUp(scenes.Begin(), artboards.Begin(), scenes.Size(), OnWarmUpDone, request);
+    return 0;
+}
 
 static const luaL_reg RIVE_FUNCTIONS[] =
 {
@@ -494,6 +745,7 @@ static const luaL_reg RIVE_FUNCTIONS[] =
     {"pointer_down",            Script_PointerDown},
     {"pointer_exit",            Script_PointerExit},
     {"get_projection_matrix",   Script_GetProjectionMatrix},
+    {"set_render_target",       Script_SetRenderTarget},
 
     {"set_file_listener",               Script_SetFileListener},
     {"set_artboard_listener",           Script_SetArtboardListener},
@@ -510,6 +762,8 @@ static const luaL_reg RIVE_FUNCTIONS[] =
     {"get_state_machine",       Script_GetStateMachine},
     {"set_view_model_instance", Script_SetViewModelInstance},
     {"get_view_model_instance", Script_GetViewModelInstance},
+    {"prewarm",                 Script_Prewarm},
+    {"warm_up",                 Script_WarmUp},
 
     // debug
     {"debug_set_blit_mode",     Script_DebugSetBlitMode},
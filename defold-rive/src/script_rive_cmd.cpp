@@ -20,6 +20,7 @@
 
 #include <common/commands.h>
 
+#include "comp_rive.h"
 #include "script_rive_handles.h"
 #include "script_rive_listeners.h"
 #include "viewmodel_instance_registry.h"
@@ -176,6 +177,7 @@ static int Script_advanceStateMachine(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->advanceStateMachine(state_machine, dt);
+    dmRive::CompRiveWakeStateMachine(state_machine);
     return 0;
 }
 
@@ -349,13 +351,13 @@ static int Script_instantiateViewModelInstanceNamed(lua_State* L)
 static int Script_referenceNestedViewModelInstance(lua_State* L)
 {
     DM_LUA_STACK_CHECK(L, 1);
-    rive::ViewModelInstanceHandle handle = CheckViewModelInstanceHandle(L, 1);
+    rive::ViewModelInstanceHandle parent = CheckViewModelInstanceHandle(L, 1);
     const char* path = luaL_checkstring(L, 2);
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     ViewModelInstanceListener* listener = new ViewModelInstanceListener();
     listener->SetAutoDeleteOnViewModelDeleted(true);
-    handle = queue->referenceNestedViewModelInstance(handle, path, listener);
+    rive::ViewModelInstanceHandle handle = queue->referenceNestedViewModelInstance(parent, path, listener);
     if (!handle)
     {
         delete listener;
@@ -363,6 +365,7 @@ static int Script_referenceNestedViewModelInstance(lua_State* L)
     else
     {
         RegisterViewModelInstanceListener(handle, listener);
+        dmRive::CompRiveLinkNestedViewModelInstance(handle, parent);
     }
     PushViewModelInstanceHandle(L, handle);
     return 1;
@@ -379,14 +382,14 @@ static int Script_referenceNestedViewModelInstance(lua_State* L)
 static int Script_referenceListViewModelInstance(lua_State* L)
 {
     DM_LUA_STACK_CHECK(L, 1);
-    rive::ViewModelInstanceHandle handle = CheckViewModelInstanceHandle(L, 1);
+    rive::ViewModelInstanceHandle parent = CheckViewModelInstanceHandle(L, 1);
     const char* path = luaL_checkstring(L, 2);
     int index = luaL_checkinteger(L, 3);
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     ViewModelInstanceListener* listener = new ViewModelInstanceListener();
     listener->SetAutoDeleteOnViewModelDeleted(true);
-    handle = queue->referenceListViewModelInstance(handle, path, index, listener);
+    rive::ViewModelInstanceHandle handle = queue->referenceListViewModelInstance(parent, path, index, listener);
     if (!handle)
     {
         delete listener;
@@ -394,6 +397,7 @@ static int Script_referenceListViewModelInstance(lua_State* L)
     else
     {
         RegisterViewModelInstanceListener(handle, listener);
+        dmRive::CompRiveLinkNestedViewModelInstance(handle, parent);
     }
     PushViewModelInstanceHandle(L, handle);
     return 1;
@@ -415,6 +419,8 @@ static int Script_setViewModelInstanceNestedViewModel(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceNestedViewModel(handle, path, value);
+    dmRive::CompRiveLinkNestedViewModelInstance(value, handle);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     return 0;
 }
 
@@ -436,6 +442,8 @@ static int Script_insertViewModelInstanceListViewModel(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->insertViewModelInstanceListViewModel(handle, path, value, index);
+    dmRive::CompRiveLinkNestedViewModelInstance(value, handle);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     AdjustViewModelListSize(handle, path, 1);
     return 0;
 }
@@ -456,6 +464,8 @@ static int Script_appendViewModelInstanceListViewModel(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->appendViewModelInstanceListViewModel(handle, path, value);
+    dmRive::CompRiveLinkNestedViewModelInstance(value, handle);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     AdjustViewModelListSize(handle, path, 1);
     return 0;
 }
@@ -476,6 +486,7 @@ static int Script_removeViewModelInstanceListViewModelIndex(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->removeViewModelInstanceListViewModel(handle, path, index, RIVE_NULL_HANDLE);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     AdjustViewModelListSize(handle, path, -1);
     return 0;
 }
@@ -496,6 +507,7 @@ static int Script_removeViewModelInstanceListViewModel(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->removeViewModelInstanceListViewModel(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     AdjustViewModelListSize(handle, path, -1);
     return 0;
 }
@@ -512,6 +524,7 @@ static int Script_deleteViewModelInstance(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->deleteViewModelInstance(handle);
+    dmRive::CompRiveUnlinkViewModelInstance(handle);
     return 0;
 }
 
@@ -533,6 +546,7 @@ static int Script_swapViewModelInstanceListValues(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->swapViewModelInstanceListValues(handle, path, indexa, indexb);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     return 0;
 }
 
@@ -553,6 +567,8 @@ static int Script_bindViewModelInstance(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->bindViewModelInstance(state_machine, view_model);
+    dmRive::CompRiveLinkViewModelInstance(view_model, state_machine);
+    dmRive::CompRiveWakeStateMachine(state_machine);
     return 0;
 }
 
@@ -574,6 +590,7 @@ static int Script_fireViewModelTrigger(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->fireViewModelTrigger(handle, path);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     return 0;
 }
 
@@ -593,6 +610,7 @@ static int Script_setViewModelInstanceBool(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceBool(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     rive::CommandQueue::ViewModelInstanceData data;
     data.metaData.name = path;
     data.metaData.type = rive::DataType::boolean;
@@ -618,6 +636,7 @@ static int Script_setViewModelInstanceNumber(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceNumber(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     rive::CommandQueue::ViewModelInstanceData data;
     data.metaData.name = path;
     data.metaData.type = rive::DataType::number;
@@ -644,6 +663,7 @@ static int Script_setViewModelInstanceColor(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceColor(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     rive::CommandQueue::ViewModelInstanceData data;
     data.metaData.name = path;
     data.metaData.type = rive::DataType::color;
@@ -669,6 +689,7 @@ static int Script_setViewModelInstanceEnum(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceEnum(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     rive::CommandQueue::ViewModelInstanceData data;
     data.metaData.name = path;
     data.metaData.type = rive::DataType::enumType;
@@ -694,6 +715,7 @@ static int Script_setViewModelInstanceString(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceString(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     rive::CommandQueue::ViewModelInstanceData data;
     data.metaData.name = path;
     data.metaData.type = rive::DataType::string;
@@ -719,6 +741,7 @@ static int Script_setViewModelInstanceImage(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceImage(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     return 0;
 }
 
@@ -738,6 +761,7 @@ static int Script_setViewModelInstanceArtboard(lua_State* L)
 
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->setViewModelInstanceArtboard(handle, path, value);
+    dmRive::CompRiveWakeViewModelInstance(handle);
     return 0;
 }
 
@@ -1083,6 +1107,7 @@ static int Script_addGlobalImageAsset(lua_State* L)
     rive::RenderImageHandle handle = CheckRenderImageHandle(L, 2);
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->addGlobalImageAsset(name, handle);
+    dmRive::CompRiveWakeAll();
     return 0;
 }
 
@@ -1097,6 +1122,7 @@ static int Script_removeGlobalImageAsset(lua_State* L)
     const char* name = luaL_checkstring(L, 1);
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->removeGlobalImageAsset(name);
+    dmRive::CompRiveWakeAll();
     return 0;
 }
 
@@ -1113,6 +1139,7 @@ static int Script_addGlobalFontAsset(lua_State* L)
     rive::FontHandle handle = CheckFontHandle(L, 2);
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->addGlobalFontAsset(name, handle);
+    dmRive::CompRiveWakeAll();
     return 0;
 }
 
@@ -1127,6 +1154,7 @@ static int Script_removeGlobalFontAsset(lua_State* L)
     const char* name = luaL_checkstring(L, 1);
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->removeGlobalFontAsset(name);
+    dmRive::CompRiveWakeAll();
     return 0;
 }
 
@@ -1143,6 +1171,7 @@ static int Script_addGlobalAudioAsset(lua_State* L)
     rive::AudioSourceHandle handle = CheckAudioSourceHandle(L, 2);
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->addGlobalAudioAsset(name, handle);
+    dmRive::CompRiveWakeAll();
     return 0;
 }
 
@@ -1157,6 +1186,7 @@ static int Script_removeGlobalAudioAsset(lua_State* L)
     const char* name = luaL_checkstring(L, 1);
     rive::rcp<rive::CommandQueue> queue = dmRiveCommands::GetCommandQueue();
     queue->removeGlobalAudioAsset(name);
+    dmRive::CompRiveWakeAll();
     return 0;
 }
 